@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "ringbuffer.h"
+#include "spscringbuffer.h"
+
+// Standard includes
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace QtJack;
+
+/**
+ * Measures the throughput of SpscRingBuffer against RingBuffer, moving
+ * audio blocks from a producer to a consumer thread the way a process
+ * callback feeds a disk writer.
+ */
+
+namespace {
+
+const int RingCapacity = 16384;
+const int BlockSize = 256;
+const long long TotalSamples = 1ll << 28;
+
+template<typename Write, typename Read>
+double measure(Write write, Read read) {
+    std::vector<AudioSample> source(BlockSize, 0.5f);
+    std::vector<AudioSample> target(BlockSize);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::thread producer([&]() {
+        for(long long written = 0; written < TotalSamples; ) {
+            int count = write(source.data(), BlockSize);
+            if(count == 0) {
+                std::this_thread::yield();
+            }
+            written += count;
+        }
+    });
+    for(long long readSamples = 0; readSamples < TotalSamples; ) {
+        int count = read(target.data(), BlockSize);
+        if(count == 0) {
+            std::this_thread::yield();
+        }
+        readSamples += count;
+    }
+    producer.join();
+
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    return TotalSamples * sizeof(AudioSample) / seconds.count() / (1 << 20);
+}
+
+} // namespace
+
+int main() {
+    AudioRingBuffer ringBuffer(RingCapacity);
+    double ringBufferThroughput = measure(
+        [&](const AudioSample *data, int count) {
+            return ringBuffer.write((AudioSample*)data, qMin(count, ringBuffer.numberOfElementsCanBeWritten()));
+        },
+        [&](AudioSample *data, int count) {
+            return ringBuffer.read(data, qMin(count, ringBuffer.numberOfElementsAvailableForRead()));
+        });
+
+    AudioSpscRingBuffer<RingCapacity> spscRingBuffer;
+    double spscRingBufferThroughput = measure(
+        [&](const AudioSample *data, int count) { return spscRingBuffer.write(data, count); },
+        [&](AudioSample *data, int count) { return spscRingBuffer.read(data, count); });
+
+    printf("RingBuffer<AudioSample>:     %10.1f MiB/s\n", ringBufferThroughput);
+    printf("SpscRingBuffer<AudioSample>: %10.1f MiB/s\n", spscRingBufferThroughput);
+    printf("Speedup:                     %10.2fx\n", spscRingBufferThroughput / ringBufferThroughput);
+    return 0;
+}
@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "ringbuffer.h"
+
+// Standard includes
+#include <atomic>
+
+namespace QtJack {
+
+/** Describes a block of samples in an AudioBlockRingBuffer. */
+struct AudioBlockHeader {
+    AudioBlockHeader() : _sequence(0), _frameTime(0), _frames(0) { }
+
+    quint64 sequence() const    { return _sequence; }
+    quint32 frameTime() const   { return _frameTime; }
+    int frames() const          { return _frames; }
+
+    /**
+     * Number of the block, counting every block handed to write(), including
+     * those that did not fit. A gap in the sequence means blocks have been
+     * dropped.
+     */
+    quint64 _sequence;
+
+    /** JACK frame time the block started at, i.e. jack_last_frame_time(). */
+    quint32 _frameTime;
+
+    /** Number of samples in the block. */
+    qint32 _frames;
+};
+
+/**
+ * @brief Single producer, single consumer ring buffer of timestamped audio blocks.
+ * Each record carries an AudioBlockHeader with a sequence number, the JACK
+ * frame time of the cycle and the number of frames, followed by the
+ * samples. Header and samples are published with one write advance, so the
+ * reader never sees a header without its samples.
+ *
+ * A block that does not fit is dropped as a whole but still consumes a
+ * sequence number. Consumers like disk writers can thus detect the gap and
+ * insert silence, and align several streams by their frame times.
+ */
+class AudioBlockRingBuffer {
+public:
+    /**
+     * Creates a ring buffer.
+     * @param numberOfFrames Total number of samples the ring buffer holds,
+     * not counting the headers of the blocks.
+     * @param framesPerBlock Expected block size, used to reserve room for
+     * the headers.
+     */
+    AudioBlockRingBuffer(int numberOfFrames = 16384, int framesPerBlock = 256);
+
+    /**
+     * Writes a block of @a frames samples that started at JACK frame time
+     * @a frameTime. Only the writing thread may call this.
+     * @returns true on success, false if the block did not fit and has been
+     * dropped.
+     */
+    bool write(const AudioSample *samples, int frames, quint32 frameTime) REALTIME_SAFE;
+
+    /**
+     * Reads the header of the next block without consuming it. Only the
+     * reading thread may call this.
+     * @returns true, if a block is available.
+     */
+    bool peek(AudioBlockHeader& header) const REALTIME_SAFE;
+
+    /**
+     * Reads the next block. At most @a maximumFrames samples are copied to
+     * @a samples, the rest of the block is skipped. Only the reading thread
+     * may call this.
+     * @returns true, if a block has been read.
+     */
+    bool read(AudioBlockHeader& header, AudioSample *samples, int maximumFrames) REALTIME_SAFE;
+
+    /** Skips the next block. @returns true, if a block has been skipped. */
+    bool skip() REALTIME_SAFE;
+
+    /** @returns the number of blocks dropped because the ring was full. */
+    quint64 numberOfDroppedBlocks() const REALTIME_SAFE;
+
+    /** @returns a snapshot of fill levels in bytes. Not a RT operation. */
+    RingBufferStatistics statistics() const { return _ringBuffer.statistics(); }
+
+private:
+    Q_DISABLE_COPY(AudioBlockRingBuffer)
+
+    typedef RingBuffer<char> ByteRingBuffer;
+
+    ByteRingBuffer _ringBuffer;
+
+    /** Sequence number of the next block. Writer only. */
+    quint64 _sequence;
+
+    std::atomic<quint64> _droppedBlocks;
+};
+
+} // namespace QtJack
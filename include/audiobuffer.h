@@ -26,12 +26,32 @@
 // Own includes
 #include "global.h"
 #include "buffer.h"
+#include "spscringbuffer.h"
+#include "broadcastringbuffer.h"
+#include "audioblockringbuffer.h"
 
 namespace QtJack {
 
 class AudioBuffer : public Buffer {
     friend class AudioPort;
+    friend class AudioPortGroup;
+    friend class Buffer;
+    friend class BufferPool;
 public:
+    /** Determines how mix() treats the previous contents of a buffer. */
+    enum MixMode {
+        MixModeReplace,
+        MixModeAccumulate
+    };
+
+    /** Shape of a gain ramp. */
+    enum GainRamp {
+        /** Gain changes linearly in amplitude. */
+        GainRampLinear,
+        /** Gain changes linearly in dB. Requires positive gains. */
+        GainRampExponential
+    };
+
     AudioBuffer();
     AudioBuffer(const AudioBuffer& other);
     virtual ~AudioBuffer();
@@ -69,15 +89,56 @@ public:
      * If the source buffer is greater than the target buffer, samples
      * will be truncated. If the target buffer is greater than the
      * source buffer, this operation affects the n samples at the
-     * beginning of the target buffer.
+     * beginning of the target buffer. The attenuation is applied in
+     * single precision.
      */
     bool addTo(AudioBuffer targetBuffer, double attenuation) const REALTIME_SAFE;
 
     /**
-     * Multiplies all samples in this buffer with @attenuation.
+     * Multiplies all samples from this buffer with a gain ramp and adds them
+     * to the given buffer. The gain starts at @a startAttenuation on the
+     * first sample and is ramped towards @a endAttenuation, which is reached
+     * right after the last sample, so that consecutive periods join without
+     * discontinuities. Exponential ramps fall back to linear ramps if either
+     * attenuation is not positive. Buffer sizes are treated like in addTo().
+     */
+    bool addTo(AudioBuffer targetBuffer,
+               double startAttenuation,
+               double endAttenuation,
+               GainRamp gainRamp = GainRampLinear) const REALTIME_SAFE;
+
+    /**
+     * Mixes the given buffers, each multiplied with its gain, into this
+     * buffer in a single pass over memory. This is considerably faster than
+     * calling addTo() once per source, because this buffer is read and
+     * written only once. Invalid source buffers are skipped. If a source
+     * buffer is smaller than this buffer, only the n samples at the
+     * beginning of this buffer are affected.
+     * @param sourceBuffers Array of @a numberOfSources buffers to mix.
+     * @param gains Array of @a numberOfSources gains, or 0 for unity gain.
+     * @param mixMode Whether to replace or to add to the contents of this buffer.
+     * @returns true on success, false otherwise.
+     */
+    bool mix(const AudioBuffer *sourceBuffers,
+             const double *gains,
+             int numberOfSources,
+             MixMode mixMode = MixModeReplace) REALTIME_SAFE;
+
+    /**
+     * Multiplies all samples in this buffer with @attenuation. The
+     * attenuation is applied in single precision.
      */
     void multiply(double attenuation) REALTIME_SAFE;
 
+    /**
+     * Multiplies all samples in this buffer with a gain ramp from
+     * @a startAttenuation to @a endAttenuation. The ramp behaves like the
+     * one of the ramped addTo().
+     */
+    void multiply(double startAttenuation,
+                  double endAttenuation,
+                  GainRamp gainRamp = GainRampLinear) REALTIME_SAFE;
+
     /**
      * Pushes the contents of this buffer to the specified ring buffer.
      * @param ringBuffer The ring buffer to write to.
@@ -92,8 +153,73 @@ public:
      */
     bool pop(AudioRingBuffer& ringBuffer) REALTIME_SAFE;
 
+    /**
+     * Pushes the contents of this buffer to the specified broadcast ring
+     * buffer, overwriting the oldest samples if necessary.
+     * @param ringBuffer The ring buffer to write to.
+     * @returns true on succes, false otherwise.
+     */
+    bool push(AudioBroadcastRingBuffer& ringBuffer) REALTIME_SAFE;
+
+    /**
+     * Pops the contents of this buffer using the specified reader of a
+     * broadcast ring buffer.
+     * @param reader The reader to read with.
+     * @returns true on succes, false if not enough samples were available
+     * or samples were lost to an overrun.
+     */
+    bool pop(AudioBroadcastRingBuffer::Reader& reader) REALTIME_SAFE;
+
+    /**
+     * Pushes the contents of this buffer as one block to the specified
+     * block ring buffer.
+     * @param ringBuffer The ring buffer to write to.
+     * @param frameTime JACK frame time of the current cycle, see
+     * Client::getJackTime().
+     * @returns true on succes, false if the block has been dropped.
+     */
+    bool push(AudioBlockRingBuffer& ringBuffer, quint32 frameTime) REALTIME_SAFE;
+
+    /**
+     * Pops the next block from the specified block ring buffer. Missing
+     * samples of a shorter block are filled with silence.
+     * @param ringBuffer The ring buffer to read from.
+     * @param header Receives the header of the block.
+     * @returns true on succes, false if no block was available.
+     */
+    bool pop(AudioBlockRingBuffer& ringBuffer, AudioBlockHeader& header) REALTIME_SAFE;
+
+    /**
+     * Pushes the contents of this buffer to the specified ring buffer.
+     * @param ringBuffer The ring buffer to write to.
+     * @returns true on succes, false otherwise.
+     */
+    template<int Capacity>
+    bool push(SpscRingBuffer<AudioSample, Capacity>& ringBuffer) REALTIME_SAFE {
+        if(!isValid() || _size > ringBuffer.numberOfElementsCanBeWritten()) {
+            return false;
+        }
+        ringBuffer.write((const AudioSample*)_jackBuffer, _size);
+        return true;
+    }
+
+    /**
+     * Pops the contents of this buffer from the specified ring buffer.
+     * @param ringBuffer The ring buffer to read from.
+     * @returns true on succes, false otherwise.
+     */
+    template<int Capacity>
+    bool pop(SpscRingBuffer<AudioSample, Capacity>& ringBuffer) REALTIME_SAFE {
+        if(!isValid() || ringBuffer.numberOfElementsAvailableForRead() < _size) {
+            return false;
+        }
+        ringBuffer.read((AudioSample*)_jackBuffer, _size);
+        return true;
+    }
+
 private:
     AudioBuffer(int size, void *buffer);
+    AudioBuffer(int size, BufferMemory *memory);
 };
 
 } // namespace QtJack
@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+
+// Standard includes
+#include <stdint.h>
+
+namespace QtJack {
+
+/**
+ * Sample kernels behind the AudioBuffer arithmetic. The fastest
+ * implementation the executing CPU supports (AVX-512, AVX2, SSE2 or NEON)
+ * is selected once when the library is loaded. The scalar fallback
+ * computes exactly the same results in single precision.
+ *
+ * Kernels operate on raw sample memory and do not validate their
+ * arguments. Source and target ranges must either be identical or
+ * must not overlap.
+ */
+namespace AudioKernels {
+
+/** @returns the name of the instruction set selected at load time. */
+const char *instructionSet();
+
+/** Sets @a count samples at @a target to zero. */
+void clear(AudioSample *target, int count) REALTIME_SAFE;
+
+/** Copies @a count samples from @a source to @a target. */
+void copy(const AudioSample *source, AudioSample *target, int count) REALTIME_SAFE;
+
+/** Adds @a count samples from @a source to @a target. */
+void add(const AudioSample *source, AudioSample *target, int count) REALTIME_SAFE;
+
+/** Multiplies @a count samples from @a source with @a gain and adds them to @a target. */
+void addScaled(const AudioSample *source, AudioSample *target, int count, AudioSample gain) REALTIME_SAFE;
+
+/** Multiplies @a count samples at @a target with @a gain. */
+void scale(AudioSample *target, int count, AudioSample gain) REALTIME_SAFE;
+
+/**
+ * Mixes @a numberOfSources source ranges, each multiplied with its gain,
+ * into @a count samples at @a target in a single pass over memory. When
+ * @a accumulate is false, the previous contents of @a target are replaced.
+ */
+void mix(const AudioSample *const *sources, const AudioSample *gains, int numberOfSources,
+         AudioSample *target, int count, bool accumulate) REALTIME_SAFE;
+
+/**
+ * Multiplies @a count samples at @a target with a linear gain ramp. Sample
+ * i is multiplied with @a startGain + i * @a increment.
+ */
+void scaleRamp(AudioSample *target, int count, AudioSample startGain, AudioSample increment) REALTIME_SAFE;
+
+/**
+ * Multiplies @a count samples from @a source with a linear gain ramp and
+ * adds them to @a target. Sample i is multiplied with
+ * @a startGain + i * @a increment.
+ */
+void addScaledRamp(const AudioSample *source, AudioSample *target, int count,
+                   AudioSample startGain, AudioSample increment) REALTIME_SAFE;
+
+/**
+ * Multiplies @a count samples at @a target with an exponential gain ramp,
+ * which is linear in dB. Sample i is multiplied with
+ * @a startGain * @a ratio ^ i.
+ */
+void scaleExponentialRamp(AudioSample *target, int count, AudioSample startGain, AudioSample ratio) REALTIME_SAFE;
+
+/**
+ * Multiplies @a count samples from @a source with an exponential gain ramp,
+ * which is linear in dB, and adds them to @a target. Sample i is multiplied
+ * with @a startGain * @a ratio ^ i.
+ */
+void addScaledExponentialRamp(const AudioSample *source, AudioSample *target, int count,
+                              AudioSample startGain, AudioSample ratio) REALTIME_SAFE;
+
+/**
+ * Converts @a count samples from @a source to integers. Each sample is
+ * multiplied with @a scale, offset by the optional @a dither value,
+ * saturated to [@a minimum, @a maximum] and rounded to nearest.
+ * @param dither Array of @a count dither values in units of the integer
+ * format, or 0 for no dither.
+ */
+void toInteger(const AudioSample *source, int32_t *target, int count, AudioSample scale,
+               AudioSample minimum, AudioSample maximum, const AudioSample *dither) REALTIME_SAFE;
+
+/** Converts @a count integers from @a source to samples multiplied with @a scale. */
+void fromInteger(const int32_t *source, AudioSample *target, int count, AudioSample scale) REALTIME_SAFE;
+
+/**
+ * Measures @a count samples at @a source for metering. Raises @a peak to
+ * the largest absolute sample value and adds the sum of squares of all
+ * samples to @a sumOfSquares.
+ * @returns the number of samples whose absolute value reaches @a clipLevel.
+ */
+int measure(const AudioSample *source, int count, AudioSample clipLevel,
+            AudioSample *peak, AudioSample *sumOfSquares) REALTIME_SAFE;
+
+} // namespace AudioKernels
+
+} // namespace QtJack
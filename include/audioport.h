@@ -32,6 +32,7 @@ namespace QtJack {
 
 class AudioPort : public Port {
     friend class Client;
+    friend class AudioPortGroup;
 public:
     AudioPort();
     AudioPort(const Port& other);
@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "audioport.h"
+
+// Qt includes
+#include <QSharedPointer>
+#include <QVector>
+#include <QList>
+
+namespace QtJack {
+
+class AudioPortGroupPrivate {
+public:
+    QVector<AudioPort> _ports;
+    QVector<jack_port_t*> _jackPorts;
+    QVector<AudioSample*> _channels;
+    int _samples;
+};
+
+/**
+ * @brief Group of audio ports that are processed together.
+ * A group resolves the buffers of all its ports once per cycle into a
+ * contiguous array of channel pointers, so that multichannel processors
+ * can loop over channels without constructing a buffer object per port.
+ * Copies of a group share the same ports and channel pointers.
+ */
+class AudioPortGroup {
+    friend class Client;
+public:
+    AudioPortGroup();
+    AudioPortGroup(const AudioPortGroup& other);
+    ~AudioPortGroup();
+
+    bool isValid() const REALTIME_SAFE { return numberOfChannels() > 0; }
+
+    /** @returns the number of ports in this group. */
+    int numberOfChannels() const REALTIME_SAFE;
+
+    /** @returns the port for the given channel. */
+    AudioPort port(int channel) const;
+
+    /** @returns all ports of this group. */
+    QList<AudioPort> ports() const;
+
+    /**
+     * Fetches the buffers of all ports for the current cycle. Call this once
+     * at the beginning of Processor::process() before accessing channels.
+     */
+    void resolveBuffers(int samples) REALTIME_SAFE;
+
+    /** @returns the number of samples of the buffers resolved last. */
+    int samples() const REALTIME_SAFE;
+
+    /**
+     * @returns an array of numberOfChannels() pointers to the sample memory
+     * of each port, as resolved by the last call to resolveBuffers().
+     */
+    AudioSample * const *channels() const REALTIME_SAFE;
+
+    /** @returns a pointer to the sample memory of the given channel. */
+    AudioSample *channel(int channel) const REALTIME_SAFE;
+
+    /** @returns a buffer referring to the resolved memory of the given channel. */
+    AudioBuffer buffer(int channel) const REALTIME_SAFE;
+
+private:
+    AudioPortGroup(QVector<AudioPort> ports);
+
+    QSharedPointer<AudioPortGroupPrivate> _p;
+};
+
+} // namespace QtJack
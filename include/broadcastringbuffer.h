@@ -0,0 +1,261 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+
+// Qt includes
+#include <QSharedPointer>
+
+// Standard includes
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace QtJack {
+
+/**
+ * Element of a broadcast ring buffer. Like SeqLock, the element is kept in
+ * atomic words, so that readers copying an element the writer overwrites
+ * at the same time is well defined. The words are as large as possible
+ * while still dividing the element size, so no space is wasted.
+ */
+template<typename Type>
+struct BroadcastRingBufferSlot {
+    typedef typename std::conditional<sizeof(Type) % 8 == 0, quint64,
+            typename std::conditional<sizeof(Type) % 4 == 0, quint32,
+            typename std::conditional<sizeof(Type) % 2 == 0, quint16,
+                                      quint8>::type>::type>::type Word;
+
+    enum { NumberOfWords = sizeof(Type) / sizeof(Word) };
+
+    void store(const Type& value) REALTIME_SAFE {
+        Word words[NumberOfWords];
+        memcpy(words, &value, sizeof(Type));
+        for(int i = 0; i < NumberOfWords; i++) {
+            _words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    void load(Type& value) const REALTIME_SAFE {
+        Word words[NumberOfWords];
+        for(int i = 0; i < NumberOfWords; i++) {
+            words[i] = _words[i].load(std::memory_order_relaxed);
+        }
+        memcpy(&value, words, sizeof(Type));
+    }
+
+    std::atomic<Word> _words[NumberOfWords];
+};
+
+/** Shared state of a broadcast ring buffer and its readers. */
+template<typename Type>
+class BroadcastRingBufferPrivate {
+public:
+    BroadcastRingBufferPrivate(int numberOfElements) {
+        _capacity = 1;
+        while(_capacity < numberOfElements) {
+            _capacity <<= 1;
+        }
+        _elements = new BroadcastRingBufferSlot<Type>[_capacity];
+        _claimIndex = 0;
+        _writeIndex = 0;
+    }
+
+    ~BroadcastRingBufferPrivate() {
+        delete[] _elements;
+    }
+
+    BroadcastRingBufferSlot<Type> *_elements;
+    int _capacity;
+
+    /** End of the range the writer is about to overwrite. */
+    std::atomic<size_t> _claimIndex;
+
+    /** End of the range readers may read. */
+    std::atomic<size_t> _writeIndex;
+};
+
+/**
+ * @brief Ring buffer with a single writer and any number of readers.
+ * The writer stores each element once and never waits for readers: when
+ * the ring is full it overwrites the oldest elements. Every Reader keeps
+ * its own cursor, so readers consume at their own pace, and a reader that
+ * falls behind by more than the capacity loses the overwritten elements
+ * only for itself. Lost elements are counted per reader.
+ *
+ * Readers validate after copying that the writer did not overwrite the
+ * elements meanwhile. Elements are stored in atomic words like in SeqLock,
+ * so copying them concurrently is well defined, and Type must be
+ * trivially copyable. Copies of a broadcast ring buffer and its readers
+ * share the same memory.
+ */
+template<typename Type>
+class BroadcastRingBuffer {
+    static_assert(std::is_trivially_copyable<Type>::value,
+                  "BroadcastRingBuffer requires a trivially copyable type");
+public:
+    /** Independent read cursor into a broadcast ring buffer. */
+    class Reader {
+        friend class BroadcastRingBuffer;
+    public:
+        Reader() : _readIndex(0), _lostElements(0) { }
+
+        bool isValid() const REALTIME_SAFE { return !_p.isNull(); }
+
+        /** @returns how many elements are available for this reader. */
+        int numberOfElementsAvailableForRead() const REALTIME_SAFE {
+            if(!isValid()) {
+                return 0;
+            }
+            size_t writeIndex = _p->_writeIndex.load(std::memory_order_acquire);
+            size_t available = writeIndex - _readIndex;
+            return available > (size_t)_p->_capacity ? _p->_capacity : (int)available;
+        }
+
+        /**
+         * Reads up to @a numberOfElements elements into @a data. Elements
+         * overwritten before this reader got to them are skipped and
+         * counted as lost.
+         * @returns the number of elements read.
+         */
+        int read(Type *data, int numberOfElements) REALTIME_SAFE {
+            if(!isValid() || numberOfElements <= 0) {
+                return 0;
+            }
+
+            size_t writeIndex = _p->_writeIndex.load(std::memory_order_acquire);
+            skipOverwritten(writeIndex);
+            int count = (int)qMin((size_t)numberOfElements, writeIndex - _readIndex);
+            if(count == 0) {
+                return 0;
+            }
+
+            size_t mask = _p->_capacity - 1;
+            for(int i = 0; i < count; i++) {
+                _p->_elements[(_readIndex + i) & mask].load(data[i]);
+            }
+
+            // Discard what the writer may have overwritten while copying.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            size_t claimIndex = _p->_claimIndex.load(std::memory_order_relaxed);
+            size_t oldest = claimIndex > (size_t)_p->_capacity ? claimIndex - _p->_capacity : 0;
+            if(_readIndex < oldest) {
+                int invalid = (int)qMin((size_t)count, oldest - _readIndex);
+                memmove(data, data + invalid, (count - invalid) * sizeof(Type));
+                _lostElements += invalid;
+                _readIndex += invalid;
+                count -= invalid;
+            }
+
+            _readIndex += count;
+            return count;
+        }
+
+        /** Skips all elements written so far. */
+        void skipToNewest() REALTIME_SAFE {
+            if(isValid()) {
+                _readIndex = _p->_writeIndex.load(std::memory_order_acquire);
+            }
+        }
+
+        /** @returns how many elements this reader lost to overruns. */
+        qint64 numberOfLostElements() const REALTIME_SAFE { return _lostElements; }
+
+    private:
+        void skipOverwritten(size_t writeIndex) REALTIME_SAFE {
+            size_t oldest = writeIndex > (size_t)_p->_capacity ? writeIndex - _p->_capacity : 0;
+            if(_readIndex < oldest) {
+                _lostElements += oldest - _readIndex;
+                _readIndex = oldest;
+            }
+        }
+
+        QSharedPointer<BroadcastRingBufferPrivate<Type> > _p;
+        size_t _readIndex;
+        qint64 _lostElements;
+    };
+
+    /**
+     * Creates a broadcast ring buffer holding at least @a numberOfElements
+     * elements. The capacity is rounded up to a power of two.
+     */
+    BroadcastRingBuffer(int numberOfElements = 4096) {
+        _p = QSharedPointer<BroadcastRingBufferPrivate<Type> >(
+            new BroadcastRingBufferPrivate<Type>(numberOfElements));
+    }
+
+    /** @returns the number of elements the ring buffer holds. */
+    int capacity() const REALTIME_SAFE { return _p->_capacity; }
+
+    /**
+     * Creates a reader that starts with the next element written. Not a
+     * realtime operation.
+     */
+    Reader createReader() const {
+        Reader reader;
+        reader._p = _p;
+        reader._readIndex = _p->_writeIndex.load(std::memory_order_acquire);
+        return reader;
+    }
+
+    /**
+     * Writes @a numberOfElements elements from @a data, overwriting the
+     * oldest elements if necessary. Only one thread may write.
+     */
+    void write(const Type *data, int numberOfElements) REALTIME_SAFE {
+        if(numberOfElements <= 0) {
+            return;
+        }
+
+        size_t writeIndex = _p->_writeIndex.load(std::memory_order_relaxed);
+        if(numberOfElements > _p->_capacity) {
+            // Only the newest elements fit, the others count as lost.
+            writeIndex += numberOfElements - _p->_capacity;
+            data += numberOfElements - _p->_capacity;
+            numberOfElements = _p->_capacity;
+        }
+
+        // Announce the range before overwriting it, so readers can
+        // detect that their copy might be torn.
+        _p->_claimIndex.store(writeIndex + numberOfElements, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        size_t mask = _p->_capacity - 1;
+        for(int i = 0; i < numberOfElements; i++) {
+            _p->_elements[(writeIndex + i) & mask].store(data[i]);
+        }
+
+        _p->_writeIndex.store(writeIndex + numberOfElements, std::memory_order_release);
+    }
+
+private:
+    QSharedPointer<BroadcastRingBufferPrivate<Type> > _p;
+};
+
+typedef BroadcastRingBuffer<AudioSample> AudioBroadcastRingBuffer;
+
+} // namespace QtJack
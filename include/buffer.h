@@ -29,6 +29,10 @@
 
 namespace QtJack {
 
+class AudioBuffer;
+class MidiBuffer;
+struct BufferMemory;
+
 /**
  * @author Jacob Dawid ( jacob.dawid@omg-it.works )
  * Handle to a memory buffer. Buffer handles are lightweight objects
@@ -52,17 +56,49 @@ public:
      */
     void *internalMemory() const;
 
+    /** @returns true, if this buffer owns its memory instead of referring to a port. */
+    bool isMemoryBuffer() const REALTIME_SAFE { return _memory != 0; }
+
+    Buffer& operator=(const Buffer& other);
+
+    /**
+     * Creates an audio buffer with its own aligned, memory locked memory.
+     * Not a RT operation, the same applies to releasing the last handle to
+     * the buffer. To obtain buffers on the process thread, use a BufferPool.
+     * @param size Size of the buffer in samples.
+     */
+    static AudioBuffer createMemoryAudioBuffer(int size);
+
+    /**
+     * Creates a MIDI event buffer with its own aligned, memory locked memory.
+     * Not a RT operation, the same applies to releasing the last handle to
+     * the buffer. To obtain buffers on the process thread, use a BufferPool.
+     * @param size Size of the buffer in bytes. Sizes below
+     * BufferPool::minimumMidiBufferSize(), i.e. Client::midiBufferSize(),
+     * are raised to it.
+     */
+    static MidiBuffer createMemoryMidiBuffer(int size);
+
 protected:
     Buffer();
     Buffer(const Buffer& other);
 
     Buffer(int size, void* buffer);
 
+    /** Constructs a buffer that adopts a reference to @a memory. */
+    Buffer(int size, BufferMemory *memory);
+
     /** Size of sample buffer. */
     int _size;
 
     /** Pointer to memory buffer. */
     void *_jackBuffer;
+
+    /** Owned memory for memory buffers, 0 for port buffers. */
+    BufferMemory *_memory;
+
+private:
+    void releaseMemory();
 };
 
 } // namespace QtJack
@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "audiobuffer.h"
+#include "midibuffer.h"
+
+// Standard includes
+#include <atomic>
+
+namespace QtJack {
+
+class Client;
+class BufferPool;
+
+/**
+ * Reference counted block of aligned memory backing a memory buffer.
+ * Buffer handles referring to the same block share its reference count.
+ */
+struct BufferMemory {
+    /** Number of buffer handles referring to this block. */
+    std::atomic<int> _references;
+
+    /** Pool this block belongs to, or 0 for a standalone block. */
+    BufferPool *_pool;
+
+    /** Aligned, possibly memory locked sample memory. */
+    void *_data;
+
+    /** Size of the memory block in bytes. */
+    int _bytes;
+
+    /** Whether the memory has been locked into RAM. */
+    bool _locked;
+};
+
+/**
+ * @brief Preallocated pool of memory buffers.
+ * All memory is allocated, aligned to 64 bytes and locked into RAM when
+ * the pool is created, so that buffers can be acquired on the JACK process
+ * thread without ever calling the allocator. Acquired buffers are reference
+ * counted handles and return to the pool when the last handle referring to
+ * them is destroyed.
+ *
+ * The pool must outlive all buffers acquired from it. Since buffer sizes
+ * are fixed at construction, recreate the pool when the JACK buffer size
+ * changes.
+ */
+class BufferPool {
+public:
+    /** Alignment of all buffer memory in bytes. */
+    enum { Alignment = 64 };
+
+    /**
+     * Minimum size of MIDI buffers in bytes until a client connected to the
+     * server, which is the default MIDI port buffer size of JACK2.
+     */
+    enum { DefaultMinimumMidiBufferSize = 32768 };
+
+    /**
+     * Creates a pool for buffers of the given sizes.
+     * @param audioBufferSize Size of each audio buffer in samples.
+     * @param numberOfAudioBuffers Number of audio buffers to preallocate.
+     * @param midiBufferSize Size of each MIDI buffer in bytes. Sizes below
+     * minimumMidiBufferSize() are raised to it, since JACK assumes MIDI
+     * buffers to be as large as its MIDI port buffers.
+     * @param numberOfMidiBuffers Number of MIDI buffers to preallocate.
+     */
+    BufferPool(int audioBufferSize,
+               int numberOfAudioBuffers,
+               int midiBufferSize = 0,
+               int numberOfMidiBuffers = 0);
+
+    /**
+     * Creates a pool with buffers sized for the given client, that is
+     * audio buffers of Client::bufferSize() samples and MIDI buffers of
+     * Client::midiBufferSize() bytes.
+     */
+    BufferPool(const Client& client,
+               int numberOfAudioBuffers,
+               int numberOfMidiBuffers = 0);
+
+    /** Releases all memory. Not a RT operation. */
+    ~BufferPool();
+
+    /** @returns true, if the pool memory has been locked into RAM. */
+    bool isMemoryLocked() const REALTIME_SAFE;
+
+    /** @returns the size of audio buffers in samples. */
+    int audioBufferSize() const REALTIME_SAFE { return _audioBufferSize; }
+
+    /** @returns the size of MIDI buffers in bytes. */
+    int midiBufferSize() const REALTIME_SAFE { return _midiBufferSize; }
+
+    /**
+     * Acquires an audio buffer from the pool. The contents of the buffer
+     * are unspecified.
+     * @returns an invalid buffer if the pool is exhausted.
+     */
+    AudioBuffer acquireAudioBuffer() REALTIME_SAFE;
+
+    /**
+     * Acquires a MIDI event buffer from the pool. Use
+     * MidiBuffer::clearEventBuffer() before writing events to it.
+     * @returns an invalid buffer if the pool is exhausted.
+     */
+    MidiBuffer acquireMidiBuffer() REALTIME_SAFE;
+
+    /** @returns the number of audio buffers that can still be acquired. */
+    int numberOfAvailableAudioBuffers() const REALTIME_SAFE;
+
+    /** @returns the number of MIDI buffers that can still be acquired. */
+    int numberOfAvailableMidiBuffers() const REALTIME_SAFE;
+
+    /**
+     * Allocates a standalone block of aligned, memory locked memory, that
+     * is freed when its last reference is released. Not a RT operation.
+     */
+    static BufferMemory *allocateMemory(int bytes);
+
+    /** Frees a standalone memory block. Not a RT operation. */
+    static void freeMemory(BufferMemory *memory);
+
+    /**
+     * @returns the smallest size of MIDI memory buffers in bytes. This is
+     * the MIDI port buffer size of the server the last client connected to,
+     * or DefaultMinimumMidiBufferSize before any client connected.
+     */
+    static int minimumMidiBufferSize() REALTIME_SAFE;
+
+    /** Sets the smallest size of MIDI memory buffers. Called by Client. */
+    static void setMinimumMidiBufferSize(int bytes) REALTIME_SAFE;
+
+private:
+    Q_DISABLE_COPY(BufferPool)
+
+    void initialize(int numberOfAudioBuffers, int numberOfMidiBuffers);
+    static BufferMemory *acquire(BufferMemory *blocks, int numberOfBlocks);
+    static int numberOfAvailable(const BufferMemory *blocks, int numberOfBlocks);
+
+    int _audioBufferSize;
+    int _midiBufferSize;
+
+    /** Single allocation holding the memory of all blocks. */
+    void *_memory;
+    size_t _memorySize;
+    bool _locked;
+
+    BufferMemory *_audioBlocks;
+    int _numberOfAudioBlocks;
+
+    BufferMemory *_midiBlocks;
+    int _numberOfMidiBlocks;
+};
+
+} // namespace QtJack
@@ -26,13 +26,16 @@
 // Own includes:
 #include "global.h"
 #include "audioport.h"
+#include "audioportgroup.h"
 #include "midiport.h"
+#include "realtimepolicy.h"
 
 // JACK includes:
 #include <jack/jack.h>
 
 // Standard includes:
 #include <iostream>
+#include <atomic>
 
 // Qt includes:
 #include <QObject>
@@ -74,6 +77,20 @@ public:
     /** Registers an audio input port. Only possible, if connected to a JACK server. */
     AudioPort registerAudioInPort(QString name);
 
+    /**
+     * Registers a group of audio output ports named "name_1" to "name_n".
+     * Only possible, if connected to a JACK server.
+     * @returns an invalid group if any of the ports could not be registered.
+     */
+    AudioPortGroup registerAudioOutPorts(QString name, int numberOfPorts);
+
+    /**
+     * Registers a group of audio input ports named "name_1" to "name_n".
+     * Only possible, if connected to a JACK server.
+     * @returns an invalid group if any of the ports could not be registered.
+     */
+    AudioPortGroup registerAudioInPorts(QString name, int numberOfPorts);
+
     /** Registers a midi output port. Only possible, if connected to a JACK server. */
     MidiPort registerMidiOutPort(QString name);
 
@@ -106,6 +123,21 @@ public:
       */
     void setMainProcessor(Processor *processor);
 
+    /**
+     * Sets the policy that will be applied to the JACK process thread
+     * when it starts. Set it before activating the client.
+     */
+    void setRealtimePolicy(RealtimePolicy realtimePolicy);
+
+    /** @returns the policy applied to the JACK process thread. */
+    RealtimePolicy realtimePolicy() const;
+
+    /**
+     * @returns the combination of RealtimePolicy::Step values that
+     * succeeded when the JACK process thread started last.
+     */
+    int appliedRealtimeSteps() const;
+
     /** Activates audio processing for this client. */
     bool activate();
 
@@ -124,6 +156,14 @@ public:
     /** @returns the current buffer size in samples. */
     int bufferSize() const;
 
+    /**
+     * @returns the size of MIDI port buffers in bytes. This is also the
+     * minimum size of MIDI memory buffers, since JACK assumes every MIDI
+     * buffer to be that large. Smaller sizes passed to
+     * Buffer::createMemoryMidiBuffer() or BufferPool are raised to it.
+     */
+    int midiBufferSize() const;
+
     /** @returns the current CPU load in percent. */
     float cpuLoad() const;
 
@@ -212,10 +252,19 @@ Q_SIGNALS:
     /** Emitted when an xrun occurred. */
     void xrunOccured();
 
+    /**
+     * Emitted from the JACK process thread after the realtime policy has
+     * been applied. Both arguments are combinations of RealtimePolicy::Step.
+     */
+    void realtimePolicyApplied(int requestedSteps, int appliedSteps);
+
 private:
     /** Registers a port. Only possible, if connected to a JACK server. */
     Port registerPort(QString name, QString portType, JackPortFlags jackPortFlags);
 
+    /** Registers a group of audio ports. Only possible, if connected to a JACK server. */
+    AudioPortGroup registerAudioPorts(QString name, int numberOfPorts, JackPortFlags jackPortFlags);
+
     // Callbacks
 
     void threadInit();
@@ -255,6 +304,12 @@ private:
 
     /** Pointer to the current processor object. */
     Processor *_processor;
+
+    /** Policy applied to the JACK process thread. */
+    RealtimePolicy _realtimePolicy;
+
+    /** Steps of the realtime policy that succeeded. */
+    std::atomic<int> _appliedRealtimeSteps;
 };
 
 } // namespace QtJack
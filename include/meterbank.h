@@ -0,0 +1,160 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "audiobuffer.h"
+#include "audioportgroup.h"
+#include "triplebuffer.h"
+
+// Qt includes
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+// Standard includes
+#include <atomic>
+#include <vector>
+
+namespace QtJack {
+
+/** Levels of a single meter, measured since the previous reading. */
+struct MeterLevel {
+    MeterLevel() : _peak(0.0f), _rms(0.0f), _clips(0) { }
+
+    AudioSample peak() const    { return _peak; }
+    AudioSample rms() const     { return _rms; }
+    int clips() const           { return _clips; }
+
+    /** Largest absolute sample value. */
+    AudioSample _peak;
+
+    /** Root mean square of all samples. */
+    AudioSample _rms;
+
+    /** Number of samples that reached the clip level. */
+    int _clips;
+};
+
+/**
+ * @brief Bank of peak, RMS and clip meters.
+ * Samples are measured on the JACK process thread with vectorized kernels
+ * and published once per cycle into a lock-free triple buffer. The
+ * Qt side polls that slot at display rate, so only one set of levels per
+ * poll crosses threads instead of the audio data itself.
+ *
+ * Levels accumulate on the process thread until the Qt side has taken
+ * them, so no peaks or clips are lost between two polls.
+ *
+ * Call measure() for each meter and then publish() exactly once per cycle
+ * from the process thread. All other methods belong to the Qt thread.
+ */
+class MeterBank : public QObject {
+    Q_OBJECT
+public:
+    MeterBank(int numberOfMeters, QObject *parent = 0);
+    virtual ~MeterBank();
+
+    /** @returns the number of meters in this bank. */
+    int numberOfMeters() const REALTIME_SAFE { return _numberOfMeters; }
+
+    /** @returns the absolute sample value counted as clipping. Defaults to 1.0. */
+    AudioSample clipLevel() const REALTIME_SAFE;
+
+    /** Sets the absolute sample value counted as clipping. */
+    void setClipLevel(AudioSample clipLevel) REALTIME_SAFE;
+
+    /** Measures @a count samples for the given meter. */
+    void measure(int meter, const AudioSample *samples, int count) REALTIME_SAFE;
+
+    /** Measures the contents of @a buffer for the given meter. */
+    void measure(int meter, const AudioBuffer& buffer) REALTIME_SAFE;
+
+    /**
+     * Measures the resolved buffers of all channels of @a portGroup for the
+     * meters starting at @a firstMeter.
+     */
+    void measure(int firstMeter, const AudioPortGroup& portGroup) REALTIME_SAFE;
+
+    /** Publishes the levels measured so far for the Qt side. */
+    void publish() REALTIME_SAFE;
+
+    /** @returns the levels of the given meter as of the last poll. */
+    MeterLevel level(int meter) const;
+
+    /** @returns the levels of all meters as of the last poll. */
+    QVector<MeterLevel> levels() const { return _levels; }
+
+    /** Starts polling every @a milliseconds. */
+    void startPolling(int milliseconds = 33);
+
+    /** Stops polling. */
+    void stopPolling();
+
+public Q_SLOTS:
+    /**
+     * Fetches the most recently published levels.
+     * @returns true, if new levels were available.
+     */
+    bool poll();
+
+Q_SIGNALS:
+    /** This signal will be emitted when poll() fetched new levels. */
+    void levelsChanged();
+
+private:
+    Q_DISABLE_COPY(MeterBank)
+
+    /** Running measurement of a single meter. */
+    struct Accumulator {
+        AudioSample _peak;
+        double _sumOfSquares;
+        int _clips;
+        int _frames;
+    };
+
+    void merge(Accumulator& target, const Accumulator& source) REALTIME_SAFE;
+
+    int _numberOfMeters;
+    std::atomic<AudioSample> _clipLevel;
+
+    /** Measurements of the current cycle. */
+    Accumulator *_cycle;
+
+    /** Measurements since the levels were last taken by the Qt side. */
+    Accumulator *_pending;
+
+    /**
+     * Levels published to the Qt side. Unlike QVector, copies of a
+     * std::vector never share data, so writing them never allocates.
+     */
+    TripleBuffer<std::vector<MeterLevel> > _published;
+
+    QVector<MeterLevel> _levels;
+    QTimer _timer;
+};
+
+} // namespace QtJack
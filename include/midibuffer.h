@@ -27,12 +27,44 @@
 #include "global.h"
 #include "buffer.h"
 #include "midievent.h"
+#include "midirecordringbuffer.h"
 
 namespace QtJack {
 
 class MidiBuffer : public Buffer {
     friend class MidiPort;
+    friend class Buffer;
+    friend class BufferPool;
 public:
+    /**
+     * Iterates the events of a MIDI buffer, decoding each event only when
+     * it is dereferenced:
+     * @code
+     * for(MidiEventView event : midiBuffer) { ... }
+     * @endcode
+     */
+    class const_iterator {
+    public:
+        const_iterator(void *jackBuffer, int index)
+            : _jackBuffer(jackBuffer), _index(index) { }
+
+        MidiEventView operator*() const REALTIME_SAFE {
+            jack_midi_event_t event;
+            if(jack_midi_event_get(&event, _jackBuffer, _index) != 0) {
+                return MidiEventView();
+            }
+            return MidiEventView(event);
+        }
+
+        const_iterator& operator++() REALTIME_SAFE { _index++; return *this; }
+        bool operator==(const const_iterator& other) const REALTIME_SAFE { return _index == other._index; }
+        bool operator!=(const const_iterator& other) const REALTIME_SAFE { return _index != other._index; }
+
+    private:
+        void *_jackBuffer;
+        int _index;
+    };
+
     MidiBuffer();
     MidiBuffer(const MidiBuffer& other);
     virtual ~MidiBuffer();
@@ -49,6 +81,19 @@ public:
     /** @returns the MIDI event at the given index. */
     MidiEvent readEvent(int index, bool *ok = 0);
 
+    /** @returns an iterator to the first MIDI event. */
+    const_iterator begin() const REALTIME_SAFE;
+
+    /** @returns an iterator past the last MIDI event. */
+    const_iterator end() const REALTIME_SAFE;
+
+    /**
+     * Decodes up to @a maximumNumberOfEvents events, starting with the
+     * event at @a firstIndex, into @a events.
+     * @returns the number of events decoded.
+     */
+    int readEvents(MidiEventView *events, int maximumNumberOfEvents, int firstIndex = 0) const REALTIME_SAFE;
+
     /** Writes sample at position i in the midi buffer. */
     bool write(int i, MidiData value) REALTIME_SAFE;
 
@@ -99,11 +144,35 @@ public:
      */
     bool pop(MidiRingBuffer& ringBuffer) REALTIME_SAFE;
 
+    /**
+     * Pushes all MIDI events of this buffer to the specified record ring
+     * buffer. Events are timestamped with @a frameTime plus their sample
+     * offset.
+     * @param ringBuffer The ring buffer to write to.
+     * @param frameTime JACK frame time of the current cycle, see
+     * Client::getJackTime().
+     * @returns true on succes, false if events have been dropped.
+     */
+    bool push(MidiRecordRingBuffer& ringBuffer, quint32 frameTime) const REALTIME_SAFE;
+
+    /**
+     * Pops the MIDI events due in the current cycle from the specified
+     * record ring buffer and writes them to this buffer. Events that are
+     * late are written at the start of the cycle, events of later cycles
+     * remain in the ring buffer.
+     * @param ringBuffer The ring buffer to read from.
+     * @param frameTime JACK frame time of the current cycle.
+     * @param frames Number of frames of the current cycle.
+     * @returns true on succes, false if events did not fit into this buffer.
+     */
+    bool pop(MidiRecordRingBuffer& ringBuffer, quint32 frameTime, int frames) REALTIME_SAFE;
+
     /** Get the number of events that could not be written to the buffer. */
     int lostEventCount();
 
 protected:
     MidiBuffer(int size, void *buffer);
+    MidiBuffer(int size, BufferMemory *memory);
 };
 
 } // namespace QtJack
@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "midibuffer.h"
+
+// Standard includes
+#include <atomic>
+#include <vector>
+
+namespace QtJack {
+
+/**
+ * @brief Drops redundant continuous MIDI messages.
+ * High resolution controllers easily send more control changes and pitch
+ * bends than downstream devices can handle. Used as an output stage, the
+ * coalescer copies the events of a source buffer to a target buffer and
+ * keeps, per channel and controller, only the last value of control
+ * changes, pitch bends, channel and poly pressure within each window. All
+ * other events pass unchanged and in order.
+ *
+ * The value kept is the last one of its window, at its own position. Notes
+ * between dropped and kept messages therefore see a different controller
+ * state than they did in the source.
+ *
+ * Controllers whose messages only make sense as a sequence, i.e. bank
+ * select, data entry, (N)RPN selection and channel mode messages, are
+ * never coalesced by default. Neither are the switch controllers, e.g.
+ * sustain, whose state between notes matters. Lookup tables are
+ * allocated in advance, so process() costs O(events) and does not
+ * allocate.
+ */
+class MidiCoalescer {
+public:
+    /**
+     * Creates a coalescer.
+     * @param window Length of a window in samples, or zero to coalesce over
+     * the whole period.
+     * @param maximumNumberOfEvents Number of events per period that can be
+     * coalesced. Further events pass unchanged.
+     */
+    MidiCoalescer(int window = 0, int maximumNumberOfEvents = 4096);
+
+    /** @returns the window length in samples, zero for the whole period. */
+    int window() const REALTIME_SAFE;
+
+    /** Sets the window length in samples, zero for the whole period. */
+    void setWindow(int window) REALTIME_SAFE;
+
+    /** @returns true, if messages of @a controller are coalesced. */
+    bool isControllerCoalesced(int controller) const REALTIME_SAFE;
+
+    /** Sets whether messages of @a controller are coalesced. */
+    void setControllerCoalesced(int controller, bool coalesced) REALTIME_SAFE;
+
+    /**
+     * Copies the events of @a source to @a target, leaving out redundant
+     * continuous messages. The target buffer is cleared first. Only the
+     * process thread may call this.
+     * @returns the number of events left out.
+     */
+    int process(const MidiBuffer& source, MidiBuffer& target) REALTIME_SAFE;
+
+    /** @returns the number of events left out so far. */
+    quint64 numberOfCoalescedEvents() const REALTIME_SAFE;
+
+private:
+    Q_DISABLE_COPY(MidiCoalescer)
+
+    enum {
+        ControlChangeSlots = 0,
+        PolyPressureSlots = 16 * 128,
+        PitchBendSlots = 2 * 16 * 128,
+        ChannelPressureSlots = PitchBendSlots + 16,
+        NumberOfSlots = ChannelPressureSlots + 16
+    };
+
+    /** @returns the lookup slot of a continuous message, or -1. */
+    int slot(const jack_midi_event_t& event) const REALTIME_SAFE;
+
+    std::atomic<int> _window;
+    std::atomic<quint64> _coalescedControllers[2];
+    std::atomic<quint64> _coalescedEvents;
+
+    /** Window stamp of the last message seen for each slot. */
+    std::vector<quint32> _stamps;
+
+    /** Whether each event of the current period is kept. */
+    std::vector<quint8> _keep;
+
+    /** Stamp of the first window of the current period. */
+    quint32 _generation;
+};
+
+} // namespace QtJack
@@ -24,6 +24,7 @@
 #pragma once
 
 // Own includes
+#include "global.h"
 class MidiPort;
 
 // JACK includes
@@ -35,6 +36,11 @@ class MidiPort;
 
 namespace QtJack {
 
+/**
+ * MIDI event as returned by jack_midi_event_get(). The event does not own
+ * its data, which points into the JACK buffer it has been read from and is
+ * valid during the current process cycle only.
+ */
 class MidiEvent :
     public jack_midi_event_t {
 public:
@@ -42,6 +48,47 @@ public:
     ~MidiEvent();
 };
 
+/**
+ * Non-owning view of a MIDI event in a JACK buffer. Like MidiEvent, the
+ * data is valid during the current process cycle only, but a view is
+ * trivially copyable and can be stored in fixed arrays.
+ */
+class MidiEventView {
+public:
+    MidiEventView() {
+        _event.time = 0;
+        _event.size = 0;
+        _event.buffer = 0;
+    }
+
+    MidiEventView(const jack_midi_event_t& event) : _event(event) { }
+
+    /** @returns true, if the view refers to an event. */
+    bool isValid() const REALTIME_SAFE { return _event.buffer != 0; }
+
+    /** @returns the sample offset of the event in the current cycle. */
+    int time() const REALTIME_SAFE { return (int)_event.time; }
+
+    /** @returns the number of bytes of the event. */
+    int size() const REALTIME_SAFE { return (int)_event.size; }
+
+    /** @returns the raw bytes of the event. */
+    const MidiData *data() const REALTIME_SAFE { return _event.buffer; }
+
+    /** @returns the byte at position i, or zero if out of range. */
+    MidiData operator[](int i) const REALTIME_SAFE {
+        return (i >= 0 && i < (int)_event.size) ? _event.buffer[i] : 0;
+    }
+
+    /** @returns the status byte, or zero for an empty event. */
+    MidiData status() const REALTIME_SAFE { return _event.size > 0 ? _event.buffer[0] : 0; }
+
+    /** @returns the channel of a channel voice message. */
+    int channel() const REALTIME_SAFE { return status() & 0x0f; }
+
+    jack_midi_event_t _event;
+};
+
 } // namespace QtJack
 
 Q_DECLARE_METATYPE(QtJack::MidiEvent)
@@ -0,0 +1,138 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "midibuffer.h"
+#include "midirecordringbuffer.h"
+
+// Qt includes
+#include <QByteArray>
+#include <QMetaType>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+namespace QtJack {
+
+/**
+ * Batch of MIDI events with their absolute JACK frame times. The bytes of
+ * all events are stored contiguously, so a batch takes two allocations
+ * regardless of the number of events.
+ */
+class MidiEventBatch {
+public:
+    /** Position of an event in the batch. */
+    struct Event {
+        quint32 _time;
+        int _offset;
+        int _size;
+    };
+
+    int numberOfEvents() const                  { return _events.size(); }
+    bool isEmpty() const                        { return _events.isEmpty(); }
+
+    /** @returns the JACK frame time of event @a i. */
+    quint32 time(int i) const                   { return _events[i]._time; }
+
+    /** @returns the number of bytes of event @a i. */
+    int size(int i) const                       { return _events[i]._size; }
+
+    /** @returns the bytes of event @a i. */
+    const MidiData *data(int i) const           { return (const MidiData*)_data.constData() + _events[i]._offset; }
+
+    /** @returns a copy of the bytes of event @a i. */
+    QByteArray message(int i) const             { return _data.mid(_events[i]._offset, _events[i]._size); }
+
+    QVector<Event> _events;
+    QByteArray _data;
+};
+
+/**
+ * @brief Delivers MIDI events from the process thread to Qt in batches.
+ * On the process thread, collect() copies the events of a MIDI buffer
+ * into a compact record ring together with their absolute JACK frame
+ * times. On the Qt side, poll() drains the ring once per tick and emits
+ * eventsReceived() once with all events received since, so a burst of
+ * MIDI costs one signal emission instead of one per event.
+ */
+class MidiEventBridge : public QObject {
+    Q_OBJECT
+public:
+    /** Creates a bridge buffering up to @a numberOfBytes bytes of MIDI records. */
+    MidiEventBridge(int numberOfBytes = 65536, QObject *parent = 0);
+    virtual ~MidiEventBridge();
+
+    /**
+     * Collects the events of @a buffer. Only the process thread may call
+     * this.
+     * @param frameTime JACK frame time of the current cycle, see
+     * Client::getJackTime().
+     * @returns true on success, false if events have been dropped.
+     */
+    bool collect(const MidiBuffer& buffer, quint32 frameTime) REALTIME_SAFE;
+
+    /** @returns the number of events dropped because the ring was full. */
+    quint64 numberOfDroppedEvents() const REALTIME_SAFE;
+
+    /** Starts polling every @a milliseconds. */
+    void startPolling(int milliseconds = 33);
+
+    /** Stops polling. */
+    void stopPolling();
+
+public Q_SLOTS:
+    /**
+     * Fetches all events collected so far.
+     * @returns true, if events were available.
+     */
+    bool poll();
+
+Q_SIGNALS:
+    /** This signal will be emitted when poll() fetched events. */
+    void eventsReceived(QtJack::MidiEventBatch batch);
+
+private:
+    Q_DISABLE_COPY(MidiEventBridge)
+
+    MidiRecordRingBuffer _ringBuffer;
+    QTimer _timer;
+};
+
+} // namespace QtJack
+
+Q_DECLARE_METATYPE(QtJack::MidiEventBatch)
+
+namespace QtJack {
+    class MidiEventBatchMetaTypeInitializer {
+    public:
+        MidiEventBatchMetaTypeInitializer() {
+            qRegisterMetaType<QtJack::MidiEventBatch>();
+        }
+    };
+
+    static MidiEventBatchMetaTypeInitializer midiEventBatchMetaTypeInitializer;
+} // namespace QtJack
@@ -0,0 +1,184 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "midibuffer.h"
+#include "reclaimer.h"
+
+// Qt includes
+#include <QVector>
+
+// Standard includes
+#include <atomic>
+#include <vector>
+
+namespace QtJack {
+
+/** Maps a MIDI controller to a parameter of a processor. */
+struct MidiMapping {
+    /** Kind of message the mapping listens to. */
+    enum Source {
+        ControlChange,
+        /** Controllers 0 to 31 paired with their LSB controllers 32 to 63. */
+        ControlChange14Bit,
+        Nrpn,
+        PitchBend,
+        ChannelPressure
+    };
+
+    /** Scaling from the controller to the parameter range. */
+    enum Curve {
+        Linear,
+        Exponential,
+        Logarithmic,
+        Toggle
+    };
+
+    MidiMapping(Source source = ControlChange, int channel = 0, int number = 0,
+                std::atomic<float> *target = 0, float minimum = 0.0f, float maximum = 1.0f,
+                Curve curve = Linear)
+        : _source(source), _channel(channel), _number(number),
+          _target(target), _minimum(minimum), _maximum(maximum),
+          _curve(curve) { }
+
+    Source _source;
+    int _channel;
+
+    /** Controller or NRPN number, unused for pitch bend and channel pressure. */
+    int _number;
+
+    /** Parameter to update. It must outlive the mapping. */
+    std::atomic<float> *_target;
+    float _minimum;
+    float _maximum;
+    Curve _curve;
+};
+
+/**
+ * @brief Updates processor parameters from incoming MIDI controllers.
+ * Mappings are compiled into a dense dispatch table indexed by channel and
+ * controller, so each incoming message finds its targets in O(1) and
+ * process() costs O(events). NRPNs are looked up by binary search in a
+ * sorted table. Curves are precomputed, and parameters are plain atomic
+ * floats that the processor reads without locking.
+ *
+ * setMappings() builds a new table on the calling thread and hands it to
+ * the process thread through an ObjectExchange. Replaced tables are
+ * retired to the reclaimer passed on construction. Together with lastControlChange() this
+ * allows MIDI learn without ever blocking the process thread.
+ */
+class MidiMap {
+public:
+    MidiMap(Reclaimer& reclaimer);
+    ~MidiMap();
+
+    /** Replaces the mappings. Mappings without a target are ignored. Not a RT operation. */
+    void setMappings(const QVector<MidiMapping>& mappings);
+
+    /** @returns the mappings set last. */
+    QVector<MidiMapping> mappings() const { return _mappings; }
+
+    /**
+     * Updates the mapped parameters from the events in @a buffer. Only the
+     * process thread may call this.
+     * @returns the number of parameter updates.
+     */
+    int process(const MidiBuffer& buffer) REALTIME_SAFE;
+
+    /**
+     * @returns the channel and controller of the last control change
+     * received, encoded as channel * 128 + controller, or -1.
+     */
+    int lastControlChange() const REALTIME_SAFE;
+
+private:
+    Q_DISABLE_COPY(MidiMap)
+
+    enum { CurveSize = 128 };
+
+    enum Kind {
+        SevenBit,
+        MostSignificant,
+        LeastSignificant,
+        FourteenBit
+    };
+
+    enum {
+        ControlChangeSlots = 0,
+        PitchBendSlots = 16 * 128,
+        ChannelPressureSlots = PitchBendSlots + 16,
+        NumberOfSlots = ChannelPressureSlots + 16
+    };
+
+    /** Compiled mapping. */
+    struct Entry {
+        std::atomic<float> *_target;
+        int _kind;
+
+        /** Controller of the most significant bits for 14 bit controllers. */
+        int _controller;
+
+        /** Channel and NRPN number, for the NRPN table only. */
+        int _key;
+
+        /** Toggle curves are not interpolated. */
+        MidiMapping::Curve _curveType;
+
+        /** Parameter value for controller values 0 to 127. */
+        float _curve[CurveSize];
+    };
+
+    struct Table {
+        std::vector<Entry> _entries;
+
+        /** Index of the first entry of each slot, plus the end. */
+        std::vector<int> _firstEntry;
+
+        /** NRPN entries sorted by key. */
+        std::vector<Entry> _nrpnEntries;
+    };
+
+    /** Per channel state of 14 bit controllers and NRPNs. */
+    struct ChannelState {
+        quint8 _controllers[128];
+        int _nrpn;
+    };
+
+    static Entry compile(const MidiMapping& mapping, int kind);
+    static float valueOf(const Entry& entry, int value, int maximum) REALTIME_SAFE;
+
+    int dispatch(const Table& table, int slot, int value, int maximum, int channel) REALTIME_SAFE;
+    int controlChange(const Table& table, int channel, int controller, int value) REALTIME_SAFE;
+
+    QVector<MidiMapping> _mappings;
+    ObjectExchange<Table> _tables;
+
+    ChannelState _channels[16];
+    std::atomic<int> _lastControlChange;
+};
+
+} // namespace QtJack
@@ -0,0 +1,130 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "ringbuffer.h"
+
+// Qt includes
+#include <QByteArray>
+
+// Standard includes
+#include <atomic>
+
+namespace QtJack {
+
+/**
+ * Header of a record in a MidiRecordRingBuffer. Messages of up to three
+ * bytes are stored inline, so a complete short message takes eight bytes.
+ * Longer messages like sysex set the size to LongRecord and are followed by
+ * their length as quint32 and the message bytes.
+ */
+struct MidiRecordHeader {
+    enum { InlineSize = 3, LongRecord = 0xff };
+
+    quint32 _time;
+    quint8 _size;
+    MidiData _data[InlineSize];
+};
+
+/**
+ * @brief Single producer, single consumer ring buffer of variable length MIDI messages.
+ * Each message is stored as a compact record with a timestamp. Short
+ * messages take eight bytes instead of the 24 bytes of a MidiMsg, and
+ * messages of any length, e.g. sysex, are stored inline. A record is
+ * published with a single write advance, so the reader always sees
+ * complete records.
+ *
+ * The meaning of the timestamp is up to the user. MidiBuffer::push() stores
+ * the JACK frame time of the event.
+ */
+class MidiRecordRingBuffer {
+public:
+    /** Creates a ring buffer holding @a numberOfBytes bytes of records. */
+    MidiRecordRingBuffer(int numberOfBytes = 65536);
+
+    /**
+     * Writes a message of @a size bytes with timestamp @a time. Only the
+     * writing thread may call this.
+     * @returns true on success, false if the message did not fit and has
+     * been dropped.
+     */
+    bool write(quint32 time, const MidiData *data, int size) REALTIME_SAFE;
+
+    /**
+     * Reads timestamp and size of the next message without consuming it.
+     * Only the reading thread may call this.
+     * @returns true, if a message is available.
+     */
+    bool peek(quint32& time, int& size) const REALTIME_SAFE;
+
+    /**
+     * Reads the next message. At most @a maximumSize bytes are copied to
+     * @a data, @a size receives the full size of the message. Only the
+     * reading thread may call this.
+     * @returns true, if a message has been read.
+     */
+    bool read(quint32& time, MidiData *data, int maximumSize, int& size) REALTIME_SAFE;
+
+    /**
+     * Reads the next message into @a data. Not a RT operation.
+     * @returns true, if a message has been read.
+     */
+    bool read(quint32& time, QByteArray& data);
+
+    /** Skips the next message. @returns true, if a message has been skipped. */
+    bool skip() REALTIME_SAFE;
+
+    /**
+     * @returns the number of record bytes available for reading. Each
+     * record takes at least eight bytes and more than the message it
+     * holds. Only the reading thread may call this.
+     */
+    int numberOfBytesAvailableForRead() const REALTIME_SAFE {
+        return _ringBuffer.numberOfElementsAvailableForRead();
+    }
+
+    /** @returns the number of messages dropped because the ring was full. */
+    quint64 numberOfDroppedMessages() const REALTIME_SAFE;
+
+    /** @returns a snapshot of fill levels in bytes. Not a RT operation. */
+    RingBufferStatistics statistics() const { return _ringBuffer.statistics(); }
+
+private:
+    Q_DISABLE_COPY(MidiRecordRingBuffer)
+
+    /**
+     * Decodes the header of the next record.
+     * @returns the size of the record header, or zero if no record is
+     * available.
+     */
+    int readHeader(const MidiRingBuffer::Vector& vector, MidiRecordHeader& header, int& size) const REALTIME_SAFE;
+
+    MidiRingBuffer _ringBuffer;
+    std::atomic<quint64> _droppedMessages;
+};
+
+} // namespace QtJack
@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "midiport.h"
+#include "reclaimer.h"
+
+// Qt includes
+#include <QVector>
+
+// Standard includes
+#include <atomic>
+#include <vector>
+
+namespace QtJack {
+
+/**
+ * Route from an input to an output of a MidiRouter, with a filter and a
+ * remapping applied to the events passing it.
+ */
+struct MidiRoute {
+    /** Message types, one bit per status nibble. */
+    enum Type {
+        NoteOff = 0x01,
+        NoteOn = 0x02,
+        PolyPressure = 0x04,
+        ControlChange = 0x08,
+        ProgramChange = 0x10,
+        ChannelPressure = 0x20,
+        PitchBend = 0x40,
+        System = 0x80,
+        AllTypes = 0xff
+    };
+
+    MidiRoute(int input = 0, int output = 0)
+        : _input(input), _output(output),
+          _channels(0xffff), _types(AllTypes),
+          _lowestNote(0), _highestNote(127),
+          _channel(-1), _transpose(0) { }
+
+    int _input;
+    int _output;
+
+    /** Channels passing the route, one bit per channel. */
+    quint16 _channels;
+
+    /** Message types passing the route, see Type. */
+    quint8 _types;
+
+    /** Range of notes passing the route, for note and poly pressure messages. */
+    quint8 _lowestNote;
+    quint8 _highestNote;
+
+    /** Channel to remap channel messages to, or -1 to keep the channel. */
+    qint8 _channel;
+
+    /** Semitones to transpose notes by. Notes out of range are dropped. */
+    qint8 _transpose;
+};
+
+/**
+ * @brief Merges, filters and routes MIDI events between ports.
+ * Each cycle, process() merges the events of all inputs by time with a
+ * k-way heap merge and passes each event through the routes of its input,
+ * so the output buffers receive events in ascending order. The cost grows
+ * with the number of events and routes rather than with the number of
+ * ports, and nothing is allocated on the process thread.
+ *
+ * Routes are compiled on the Qt side by setRoutes() and handed over to the
+ * process thread through an ObjectExchange. Replaced route tables are
+ * retired to the reclaimer passed on construction.
+ */
+class MidiRouter {
+public:
+    MidiRouter(const QVector<MidiPort>& inputs, const QVector<MidiPort>& outputs,
+               Reclaimer& reclaimer);
+    ~MidiRouter();
+
+    /** @returns the number of inputs. */
+    int numberOfInputs() const { return _inputs.size(); }
+
+    /** @returns the number of outputs. */
+    int numberOfOutputs() const { return _outputs.size(); }
+
+    /**
+     * Replaces the routes. Routes with invalid inputs or outputs are
+     * ignored. Not a RT operation.
+     */
+    void setRoutes(const QVector<MidiRoute>& routes);
+
+    /** @returns the routes set last. */
+    QVector<MidiRoute> routes() const { return _routes; }
+
+    /** Routes the events of the current cycle. Only the process thread may call this. */
+    void process(int samples) REALTIME_SAFE;
+
+private:
+    Q_DISABLE_COPY(MidiRouter)
+
+    /** Routes grouped by input. */
+    struct RouteTable {
+        std::vector<MidiRoute> _routes;
+
+        /** Index of the first route of each input, plus the end. */
+        std::vector<int> _firstRoute;
+    };
+
+    void route(const RouteTable& table, int input, const jack_midi_event_t& event) REALTIME_SAFE;
+    void siftDown(int position) REALTIME_SAFE;
+    bool isEarlier(int a, int b) const REALTIME_SAFE;
+
+    QVector<MidiPort> _inputs;
+    QVector<MidiPort> _outputs;
+    QVector<MidiRoute> _routes;
+
+    ObjectExchange<RouteTable> _tables;
+
+    // Merge state of the current cycle.
+    std::vector<void*> _inputBuffers;
+    std::vector<void*> _outputBuffers;
+    std::vector<jack_midi_event_t> _events;
+    std::vector<int> _nextEvent;
+    std::vector<int> _numberOfEvents;
+    std::vector<int> _heap;
+    int _heapSize;
+};
+
+} // namespace QtJack
@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "midibuffer.h"
+#include "mpscqueue.h"
+
+// Standard includes
+#include <atomic>
+
+namespace QtJack {
+
+/** Short MIDI message scheduled for an absolute JACK frame time. */
+struct ScheduledMidiEvent {
+    enum { MaximumSize = 3 };
+
+    quint32 _time;
+    quint32 _order;
+    quint8 _size;
+    MidiData _data[MaximumSize];
+};
+
+/**
+ * @brief Plays MIDI events at absolute JACK frame times.
+ * Any thread may schedule events ahead of time with schedule(). The events
+ * pass through a lock-free queue into a preallocated binary heap ordered by
+ * frame time, so scheduling costs O(log n) on the realtime thread and never
+ * allocates. Each cycle, process() writes only the events due in the
+ * current period to the output buffer, at their exact sample offsets.
+ * Events with the same frame time are played in the order they were
+ * scheduled.
+ *
+ * Frame times are compared as signed differences, so scheduling works
+ * across the wraparound of the JACK frame time as long as events are less
+ * than 2^31 frames apart.
+ */
+class MidiScheduler {
+public:
+    enum { QueueCapacity = 1024 };
+
+    /** Creates a scheduler holding at most @a capacity pending events. */
+    MidiScheduler(int capacity = 4096);
+    ~MidiScheduler();
+
+    /**
+     * Schedules a message of up to three bytes for JACK frame time
+     * @a frameTime. May be called from any thread.
+     * @returns true on success, false if the input queue was full.
+     */
+    bool schedule(quint32 frameTime, const MidiData *data, int size) REALTIME_SAFE;
+
+    /**
+     * Writes the events due in the current cycle to @a buffer. Events that
+     * are late are written at the start of the cycle. Only the process
+     * thread may call this.
+     * @param frameTime JACK frame time of the current cycle, see
+     * Client::getJackTime().
+     * @param frames Number of frames of the current cycle.
+     * @returns true on success, false if events have been lost because the
+     * scheduler or the output buffer were full.
+     */
+    bool process(MidiBuffer& buffer, quint32 frameTime, int frames) REALTIME_SAFE;
+
+    /** Discards all pending events. Only the process thread may call this. */
+    void clear() REALTIME_SAFE;
+
+    /** @returns the number of events waiting in the heap. Process thread only. */
+    int numberOfPendingEvents() const REALTIME_SAFE { return _size; }
+
+    /** @returns the number of events lost so far. */
+    quint64 numberOfDroppedEvents() const REALTIME_SAFE;
+
+private:
+    Q_DISABLE_COPY(MidiScheduler)
+
+    /** Moves scheduled events from the input queue into the heap. */
+    bool collect() REALTIME_SAFE;
+
+    void insert(const ScheduledMidiEvent& event) REALTIME_SAFE;
+    void removeFirst() REALTIME_SAFE;
+
+    static bool isEarlier(const ScheduledMidiEvent& a, const ScheduledMidiEvent& b) REALTIME_SAFE {
+        qint32 difference = (qint32)(a._time - b._time);
+        return difference < 0 || (difference == 0 && (qint32)(a._order - b._order) < 0);
+    }
+
+    MpscQueue<ScheduledMidiEvent, QueueCapacity> _queue;
+    ScheduledMidiEvent *_heap;
+    int _capacity;
+    int _size;
+    quint32 _order;
+    std::atomic<quint64> _droppedEvents;
+};
+
+} // namespace QtJack
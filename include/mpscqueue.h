@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+
+// Qt includes
+#include <QtGlobal>
+
+// Standard includes
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace QtJack {
+
+/**
+ * @brief Bounded lock-free multiple producer, single consumer queue.
+ * Any number of threads may push elements concurrently without ever taking
+ * a lock, while exactly one thread, usually the JACK process thread, pops
+ * them in order. Each slot carries a sequence number that tells producers
+ * and the consumer whether it is free or holds a published element, so
+ * producers only contend on a single compare-and-swap of the enqueue index.
+ *
+ * A producer that is preempted between claiming and publishing a slot
+ * makes the queue appear empty at that slot until it resumes; the consumer
+ * never waits for it. Capacity must be a power of two. Slots are allocated
+ * on construction.
+ */
+template<typename Type, int Capacity>
+class MpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+public:
+    MpscQueue()
+        : _slots(new Slot[Capacity]),
+          _enqueueIndex(0),
+          _dequeueIndex(0) {
+        for(int i = 0; i < Capacity; i++) {
+            _slots[i]._sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpscQueue() {
+        delete[] _slots;
+    }
+
+    /** @returns the number of elements this queue can hold. */
+    static constexpr int capacity() REALTIME_SAFE { return Capacity; }
+
+    /**
+     * Pushes @a element from any thread.
+     * @returns false if the queue is full.
+     */
+    bool push(const Type& element) REALTIME_SAFE {
+        size_t index = _enqueueIndex.load(std::memory_order_relaxed);
+        for(;;) {
+            Slot& slot = _slots[index & Mask];
+            size_t sequence = slot._sequence.load(std::memory_order_acquire);
+            ptrdiff_t difference = (ptrdiff_t)(sequence - index);
+            if(difference == 0) {
+                // The slot is free, try to claim it.
+                if(_enqueueIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed)) {
+                    slot._element = element;
+                    slot._sequence.store(index + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if(difference < 0) {
+                // The slot still holds an element from the previous lap.
+                return false;
+            } else {
+                // Another producer claimed the slot first.
+                index = _enqueueIndex.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Pops the oldest element into @a element. Only the consuming thread
+     * may call this.
+     * @returns false if no element is available.
+     */
+    bool pop(Type& element) REALTIME_SAFE {
+        Slot& slot = _slots[_dequeueIndex & Mask];
+        if(slot._sequence.load(std::memory_order_acquire) != _dequeueIndex + 1) {
+            return false;
+        }
+        element = std::move(slot._element);
+        slot._sequence.store(_dequeueIndex + Capacity, std::memory_order_release);
+        _dequeueIndex++;
+        return true;
+    }
+
+private:
+    Q_DISABLE_COPY(MpscQueue)
+
+    enum { Mask = Capacity - 1, CacheLineSize = 64 };
+
+    struct Slot {
+        std::atomic<size_t> _sequence;
+        Type _element;
+    };
+
+    Slot *_slots;
+
+    // Shared by all producers.
+    alignas(CacheLineSize) std::atomic<size_t> _enqueueIndex;
+
+    // Owned by the consumer.
+    alignas(CacheLineSize) size_t _dequeueIndex;
+};
+
+} // namespace QtJack
@@ -26,17 +26,44 @@
 // Own includes
 #include "global.h"
 #include "client.h"
+#include "mpscqueue.h"
 
+// Standard includes
+#include <atomic>
 
 namespace QtJack {
+
+/**
+ * Command posted to a processor from any thread. The meaning of the fields
+ * is up to the processor; commands are copied by value, so they must not
+ * own resources.
+ */
+struct ProcessorCommand {
+    ProcessorCommand(int command = 0, int index = 0, double value = 0.0, void *data = 0) {
+        _command = command;
+        _index = index;
+        _value = value;
+        _data = data;
+    }
+
+    int _command;
+    int _index;
+    double _value;
+    void *_data;
+};
+
 /**
  * @author Jacob Dawid ( jacob.dawid@omg-it.works )
  */
 class Processor {
 public:
+    /** Maximum number of commands waiting to be dispatched. */
+    enum { CommandQueueCapacity = 256 };
+
     /** Constructs a new processor. */
     Processor(Client& client) :
-        _client(client) {
+        _client(client),
+        _commandBudget(64) {
     }
 
     /** Destructor. */
@@ -48,8 +75,53 @@ public:
      */
     virtual void process(int samples) { Q_UNUSED(samples); }
 
+    /**
+     * @brief Called on the process thread for each posted command.
+     * Warning: This method is time-critical.
+     */
+    virtual void processCommand(const ProcessorCommand& command) { Q_UNUSED(command); }
+
+    /**
+     * Posts a command to this processor. Never blocks and may be called
+     * from any number of threads concurrently.
+     * @returns false if the command queue is full.
+     */
+    bool postCommand(const ProcessorCommand& command) REALTIME_SAFE {
+        return _commands.push(command);
+    }
+
+    /**
+     * Dispatches up to @a budget posted commands to processCommand(). The
+     * client calls this with commandBudget() at the beginning of each cycle,
+     * before process(). Remaining commands are dispatched in later cycles.
+     * @returns the number of commands dispatched.
+     */
+    int dispatchCommands(int budget) REALTIME_SAFE {
+        ProcessorCommand command;
+        int dispatched = 0;
+        while(dispatched < budget && _commands.pop(command)) {
+            processCommand(command);
+            dispatched++;
+        }
+        return dispatched;
+    }
+
+    /** @returns the maximum number of commands dispatched per cycle. */
+    int commandBudget() const REALTIME_SAFE {
+        return _commandBudget.load(std::memory_order_relaxed);
+    }
+
+    /** Sets the maximum number of commands dispatched per cycle. */
+    void setCommandBudget(int commandBudget) REALTIME_SAFE {
+        _commandBudget.store(commandBudget, std::memory_order_relaxed);
+    }
+
 protected:
     Client& _client;
+
+private:
+    MpscQueue<ProcessorCommand, CommandQueueCapacity> _commands;
+    std::atomic<int> _commandBudget;
 };
 
 } // namespace QtJack
@@ -0,0 +1,200 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "processor.h"
+#include "audiobuffer.h"
+#include "bufferpool.h"
+#include "reclaimer.h"
+
+// Qt includes
+#include <QObject>
+#include <QVector>
+
+// Standard includes
+#include <atomic>
+#include <vector>
+
+namespace QtJack {
+
+/**
+ * Processor that can be part of a ProcessorGraph. It declares a fixed
+ * number of audio inputs and outputs, and the graph passes it the buffers
+ * connected to them each cycle.
+ */
+class GraphProcessor : public Processor {
+public:
+    GraphProcessor(Client& client, int numberOfInputs, int numberOfOutputs) :
+        Processor(client),
+        _numberOfInputs(numberOfInputs > 0 ? numberOfInputs : 0),
+        _numberOfOutputs(numberOfOutputs > 0 ? numberOfOutputs : 0) {
+    }
+
+    using Processor::process;
+
+    /**
+     * @brief Called by the graph whenever audio samples have to be processed.
+     * Inputs must not be modified, since other processors may read the
+     * same buffers. Unconnected inputs are silent, output buffers have
+     * unspecified contents and must be written completely.
+     * Warning: This method is time-critical.
+     */
+    virtual void process(int samples, const AudioBuffer *inputs, AudioBuffer *outputs) = 0;
+
+    int numberOfInputs() const REALTIME_SAFE { return _numberOfInputs; }
+    int numberOfOutputs() const REALTIME_SAFE { return _numberOfOutputs; }
+
+private:
+    int _numberOfInputs;
+    int _numberOfOutputs;
+};
+
+/**
+ * @brief Runs a graph of processors in dependency order.
+ * Processors are added to the graph and their outputs connected to inputs
+ * of other processors. An output may feed any number of inputs, an input
+ * is fed by at most one output. compile() sorts the graph topologically,
+ * assigns buffers from a preallocated pool, reusing a buffer as soon as
+ * its last reader ran, and produces a flat list of steps. The process
+ * thread then only walks that list, dispatching commands and calling
+ * process() of each processor once.
+ *
+ * Editing the graph and compiling happen on the Qt side. The compiled
+ * plan is handed to the process thread through an ObjectExchange, and
+ * replaced plans are retired to the reclaimer passed on construction.
+ * Set the graph as main processor of the client. The graph recompiles
+ * itself when the JACK buffer size changes, and skips cycles longer than
+ * the buffers of its plan until then.
+ */
+class ProcessorGraph : public Processor {
+public:
+    ProcessorGraph(Client& client, Reclaimer& reclaimer);
+    virtual ~ProcessorGraph();
+
+    /**
+     * Adds @a processor to the graph. The graph does not take ownership.
+     * Not a RT operation.
+     * @returns the node of the processor.
+     */
+    int addProcessor(GraphProcessor *processor);
+
+    /**
+     * Removes the processor at @a node and all its connections. The
+     * process thread keeps running the processor until it picked up the
+     * plan of the next compile(), so delete the processor only once
+     * isPlanActive() returns true after compiling. Not a RT operation.
+     */
+    void removeProcessor(int node);
+
+    /** @returns the processor at @a node, or 0. */
+    GraphProcessor *processor(int node) const;
+
+    /**
+     * Connects @a output of @a sourceNode to @a input of @a targetNode,
+     * replacing any previous connection of the input. Not a RT operation.
+     * @returns true on success.
+     */
+    bool connect(int sourceNode, int output, int targetNode, int input);
+
+    /** Disconnects @a input of @a targetNode. Not a RT operation. */
+    void disconnect(int targetNode, int input);
+
+    /**
+     * Compiles the graph and hands the plan to the process thread. Changes
+     * take effect only after compiling. Not a RT operation.
+     * @returns false if the graph has a cycle, in which case the previous
+     * plan stays in use.
+     */
+    bool compile();
+
+    /**
+     * @returns true, if the process thread runs the plan of the last
+     * successful compile(). Processors removed before that compile() are
+     * not called anymore then.
+     */
+    bool isPlanActive() const;
+
+    /** Runs the compiled plan. */
+    void process(int samples) override;
+
+private:
+    Q_DISABLE_COPY(ProcessorGraph)
+
+    struct Connection {
+        int _sourceNode;
+        int _output;
+        int _targetNode;
+        int _input;
+    };
+
+    struct Step {
+        GraphProcessor *_processor;
+        const AudioBuffer *_inputs;
+        AudioBuffer *_outputs;
+    };
+
+    /** Compiled execution plan. */
+    struct Plan {
+        Plan(const Client& client, int numberOfBuffers, int generation)
+            : _pool(client, numberOfBuffers),
+              _bufferSize(client.bufferSize()),
+              _generation(generation) { }
+
+        BufferPool _pool;
+
+        /** Number of samples the buffers hold. */
+        int _bufferSize;
+
+        /** Number of the compile() that produced this plan. */
+        int _generation;
+
+        /** Pool buffers, the last one is silence for unconnected inputs. */
+        std::vector<AudioBuffer> _buffers;
+
+        /** Buffers of all steps, referred to by the steps. */
+        std::vector<AudioBuffer> _inputs;
+        std::vector<AudioBuffer> _outputs;
+
+        std::vector<Step> _steps;
+    };
+
+    bool isValidNode(int node) const;
+
+    QVector<GraphProcessor*> _processors;
+    QVector<Connection> _connections;
+
+    ObjectExchange<Plan> _plans;
+    int _generation;
+
+    /** Generation of the plan the process thread runs. */
+    std::atomic<int> _activeGeneration;
+
+    /** Receives buffer size changes on the thread of the graph. */
+    QObject _context;
+};
+
+} // namespace QtJack
@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+
+// Qt includes
+#include <QList>
+
+namespace QtJack {
+
+/**
+ * @brief Setup steps applied to the JACK process thread when it starts.
+ * Assign a policy to a client with Client::setRealtimePolicy() before
+ * activating it. The default policy performs no steps at all.
+ */
+class RealtimePolicy {
+public:
+    enum Step {
+        /** No step. */
+        StepNone            = 0,
+        /** Flush denormals to zero and treat denormal inputs as zero. */
+        StepFlushDenormals  = 1,
+        /** Pin the process thread to a set of CPUs. */
+        StepPinThread       = 2,
+        /** Touch a fixed amount of stack so it is mapped before processing. */
+        StepPrefaultStack   = 4,
+        /** Lock all current and future memory of the process into RAM. */
+        StepLockMemory      = 8
+    };
+
+    RealtimePolicy();
+
+    /**
+     * @returns a policy that flushes denormals and prefaults 64 KiB of
+     * stack, which is safe for any client.
+     */
+    static RealtimePolicy recommended();
+
+    /** @returns whether denormals will be flushed to zero. */
+    bool flushDenormals() const { return _flushDenormals; }
+
+    /** Enables flushing denormals to zero. */
+    void setFlushDenormals(bool flushDenormals) { _flushDenormals = flushDenormals; }
+
+    /** @returns the CPUs the process thread will be pinned to. */
+    QList<int> cpuAffinity() const { return _cpuAffinity; }
+
+    /** Pins the process thread to the given CPUs. An empty list disables pinning. */
+    void setCpuAffinity(QList<int> cpus) { _cpuAffinity = cpus; }
+
+    /** @returns the amount of stack to prefault in bytes. */
+    int stackPrefaultSize() const { return _stackPrefaultSize; }
+
+    /**
+     * Sets the amount of stack to prefault in bytes. Zero disables
+     * prefaulting. Must stay well below the stack size of the JACK thread.
+     */
+    void setStackPrefaultSize(int bytes) { _stackPrefaultSize = bytes; }
+
+    /** @returns whether all memory of the process will be locked. */
+    bool lockMemory() const { return _lockMemory; }
+
+    /** Enables locking all memory of the process into RAM. */
+    void setLockMemory(bool lockMemory) { _lockMemory = lockMemory; }
+
+    /** @returns the combination of steps this policy requests. */
+    int requestedSteps() const;
+
+    /**
+     * Applies this policy to the calling thread.
+     * @returns the combination of steps that succeeded.
+     */
+    int apply() const;
+
+private:
+    static bool applyFlushDenormals();
+    static bool applyCpuAffinity(QList<int> cpus);
+    static bool applyStackPrefault(int bytes);
+    static bool applyLockMemory();
+
+    bool _flushDenormals;
+    QList<int> _cpuAffinity;
+    int _stackPrefaultSize;
+    bool _lockMemory;
+};
+
+} // namespace QtJack
@@ -0,0 +1,196 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "spscringbuffer.h"
+
+// Qt includes
+#include <QObject>
+#include <QTimer>
+
+// Standard includes
+#include <atomic>
+#include <memory>
+
+namespace QtJack {
+
+/**
+ * @brief Deferred reclamation of objects retired by the process thread.
+ * Freeing memory on the JACK process thread may block in the allocator, so
+ * a processor that swaps out a sample, an impulse response or a table hands
+ * the old object to a reclaimer instead. The reclaimer frees retired
+ * objects in batches on the Qt thread it lives in, periodically from
+ * construction on, or when reclaim() is called. ObjectExchange retires
+ * the objects it replaces this way.
+ *
+ * Retiring never allocates. Only one thread, usually the process thread,
+ * may retire objects. If the return queue is full, retiring fails and the
+ * caller keeps the object, so it can try again in the next cycle.
+ */
+class Reclaimer : public QObject {
+    Q_OBJECT
+public:
+    /** Maximum number of objects of each kind waiting to be reclaimed. */
+    enum { Capacity = 1024 };
+
+    /** Creates a reclaimer that reclaims every 100 milliseconds. */
+    Reclaimer(QObject *parent = 0);
+
+    /** Reclaims all objects still waiting. */
+    virtual ~Reclaimer();
+
+    /**
+     * Retires @a object, which will be freed with @a deleter.
+     * @returns false if the return queue is full.
+     */
+    bool retire(void *object, void (*deleter)(void*)) REALTIME_SAFE;
+
+    /**
+     * Retires @a object, which will be freed with delete.
+     * @returns false if the return queue is full.
+     */
+    template<typename Type>
+    bool retire(Type *object) REALTIME_SAFE {
+        return retire((void*)object, &Reclaimer::deleteObject<Type>);
+    }
+
+    /**
+     * Retires the reference held by @a object, so that releasing the last
+     * reference happens on the reclaiming thread. On success @a object is
+     * left empty, otherwise it is unchanged.
+     * @returns false if the return queue is full.
+     */
+    template<typename Type>
+    bool retire(std::shared_ptr<Type>& object) REALTIME_SAFE {
+        // Only this thread writes, so the space checked here stays available.
+        if(_sharedObjects.numberOfElementsCanBeWritten() == 0) {
+            return false;
+        }
+        return _sharedObjects.push(std::shared_ptr<void>(std::move(object)));
+    }
+
+    /** Starts reclaiming every @a milliseconds. */
+    void startReclaiming(int milliseconds = 100);
+
+    /** Stops reclaiming periodically. */
+    void stopReclaiming();
+
+public Q_SLOTS:
+    /**
+     * Frees all objects retired so far.
+     * @returns the number of objects freed.
+     */
+    int reclaim();
+
+private:
+    Q_DISABLE_COPY(Reclaimer)
+
+    template<typename Type>
+    static void deleteObject(void *object) {
+        delete static_cast<Type*>(object);
+    }
+
+    /** Object retired together with its deleter. */
+    struct RetiredObject {
+        void *_object;
+        void (*_deleter)(void*);
+    };
+
+    SpscRingBuffer<RetiredObject, Capacity> _retiredObjects;
+    SpscRingBuffer<std::shared_ptr<void>, Capacity> _sharedObjects;
+    QTimer _timer;
+};
+
+/**
+ * @brief Hands objects, like compiled tables, from the Qt side to the
+ * process thread.
+ * publish() stores a new object for the process thread, and acquire()
+ * switches the process thread over to the newest one. The object replaced
+ * is retired to the reclaimer passed on construction and freed with the
+ * next batch on its Qt thread, so the process thread never frees memory. Exchanges acquired on the same process
+ * thread can share one reclaimer. If the reclaimer is full, the replaced
+ * object is kept and retired again in later cycles, and the process
+ * thread keeps using the current object until then.
+ */
+template<typename Type>
+class ObjectExchange {
+public:
+    /**
+     * Creates an exchange using @a object until something is published.
+     * Replaced objects are retired to @a reclaimer, which must outlive the
+     * exchange.
+     */
+    ObjectExchange(Reclaimer& reclaimer, Type *object = 0)
+        : _reclaimer(reclaimer), _pending(0), _current(object), _retiring(0) {
+    }
+
+    /** Frees all objects. The process thread must not use the exchange anymore. */
+    ~ObjectExchange() {
+        delete _pending.exchange(0);
+        delete _retiring;
+        delete _current;
+    }
+
+    /** Publishes @a object, taking ownership. Not a RT operation. */
+    void publish(Type *object) {
+        // An object the process thread did not pick up yet is not in use.
+        delete _pending.exchange(object, std::memory_order_acq_rel);
+    }
+
+    /**
+     * @returns the newest object published. Only the process thread may
+     * call this.
+     */
+    Type *acquire() REALTIME_SAFE {
+        if(_retiring && _reclaimer.retire(_retiring)) {
+            _retiring = 0;
+        }
+        if(!_retiring) {
+            Type *object = _pending.exchange(0, std::memory_order_acq_rel);
+            if(object) {
+                _retiring = _current;
+                _current = object;
+                if(_retiring && _reclaimer.retire(_retiring)) {
+                    _retiring = 0;
+                }
+            }
+        }
+        return _current;
+    }
+
+private:
+    Q_DISABLE_COPY(ObjectExchange)
+
+    Reclaimer& _reclaimer;
+    std::atomic<Type*> _pending;
+    Type *_current;
+
+    /** Replaced object that did not fit into the reclaimer yet. */
+    Type *_retiring;
+};
+
+} // namespace QtJack
@@ -29,31 +29,237 @@
 // Qt includes
 #include <QSharedPointer>
 #include <QVector>
+#include <QMetaType>
 
 // Own includes
 #include "global.h"
 
+// Standard includes
+#include <atomic>
+#include <cstring>
+
 namespace QtJack {
 
+/** Fill levels and failures of a ring buffer, in elements. */
+struct RingBufferStatistics {
+    RingBufferStatistics() {
+        _capacity = 0;
+        _fill = 0;
+        _highWater = 0;
+        _lowWater = 0;
+        _failedWrites = 0;
+        _failedReads = 0;
+        _droppedElements = 0;
+    }
+
+    int capacity() const            { return _capacity; }
+    int fill() const                { return _fill; }
+    int highWater() const           { return _highWater; }
+    int lowWater() const            { return _lowWater; }
+    qint64 failedWrites() const     { return _failedWrites; }
+    qint64 failedReads() const      { return _failedReads; }
+    qint64 droppedElements() const  { return _droppedElements; }
+
+    /** Number of elements the ring buffer can hold. */
+    int _capacity;
+
+    /** Number of elements available for reading when taking the snapshot. */
+    int _fill;
+
+    /** Highest fill level seen after a write. */
+    int _highWater;
+
+    /** Lowest fill level seen before a read, or the capacity if there was no read. */
+    int _lowWater;
+
+    /** Number of writes that could not write all elements. */
+    qint64 _failedWrites;
+
+    /** Number of reads that could not read all elements. */
+    qint64 _failedReads;
+
+    /** Number of elements that could not be written. */
+    qint64 _droppedElements;
+};
+
 /** Lock-free ringbuffer. */
 class RingBufferPrivate {
 public:
-    RingBufferPrivate(int size) {
+    RingBufferPrivate(int size, int bytesPerElement = 1) {
         _jackRingBuffer = jack_ringbuffer_create(size);
+        _bytesPerElement = bytesPerElement;
+        _notificationFd = -1;
+        _watermark = 0;
+        resetStatistics();
     }
 
     virtual ~RingBufferPrivate() {
         jack_ringbuffer_free(_jackRingBuffer);
     }
 
+    /**
+     * Signals the notification descriptor if writing @a bytes made the
+     * fill level cross the watermark.
+     */
+    void notifyWritten(size_t bytes) REALTIME_SAFE {
+        int fd = _notificationFd.load(std::memory_order_acquire);
+        if(fd < 0 || bytes == 0) {
+            return;
+        }
+        size_t fill = jack_ringbuffer_read_space(_jackRingBuffer);
+        size_t watermark = (size_t)_watermark.load(std::memory_order_relaxed);
+        // The reader may have drained concurrently, so that the fill level
+        // is below the bytes just written.
+        if(fill >= watermark && (fill < bytes || fill - bytes < watermark)) {
+            signalNotification(fd);
+        }
+    }
+
+    /** Wakes up the reader waiting on @a fd. Never blocks. */
+    static void signalNotification(int fd) REALTIME_SAFE;
+
+    /**
+     * Records a write of @a writtenBytes out of @a requestedBytes. Only the
+     * writing thread updates these counters, so relaxed loads and stores
+     * suffice.
+     */
+    void recordWrite(size_t requestedBytes, size_t writtenBytes) REALTIME_SAFE {
+        size_t fill = jack_ringbuffer_read_space(_jackRingBuffer);
+        if(fill > _highWater.load(std::memory_order_relaxed)) {
+            _highWater.store(fill, std::memory_order_relaxed);
+        }
+        if(writtenBytes < requestedBytes) {
+            _failedWrites.store(_failedWrites.load(std::memory_order_relaxed) + 1,
+                                std::memory_order_relaxed);
+            _droppedBytes.store(_droppedBytes.load(std::memory_order_relaxed) + (requestedBytes - writtenBytes),
+                                std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Records a read of @a readBytes out of @a requestedBytes. Only the
+     * reading thread updates these counters.
+     */
+    void recordRead(size_t requestedBytes, size_t readBytes) REALTIME_SAFE {
+        size_t fill = jack_ringbuffer_read_space(_jackRingBuffer) + readBytes;
+        if(fill < _lowWater.load(std::memory_order_relaxed)) {
+            _lowWater.store(fill, std::memory_order_relaxed);
+        }
+        if(readBytes < requestedBytes) {
+            _failedReads.store(_failedReads.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+        }
+    }
+
+    /** @returns a snapshot of the statistics. Not a RT operation. */
+    RingBufferStatistics statistics() const {
+        RingBufferStatistics statistics;
+        size_t capacity = _jackRingBuffer->size - 1;
+        size_t lowWater = _lowWater.load(std::memory_order_relaxed);
+        statistics._capacity = (int)(capacity / _bytesPerElement);
+        statistics._fill = (int)(jack_ringbuffer_read_space(_jackRingBuffer) / _bytesPerElement);
+        statistics._highWater = (int)(_highWater.load(std::memory_order_relaxed) / _bytesPerElement);
+        statistics._lowWater = (int)(qMin(lowWater, capacity) / _bytesPerElement);
+        statistics._failedWrites = _failedWrites.load(std::memory_order_relaxed);
+        statistics._failedReads = _failedReads.load(std::memory_order_relaxed);
+        statistics._droppedElements = _droppedBytes.load(std::memory_order_relaxed) / _bytesPerElement;
+        return statistics;
+    }
+
+    /** Resets the statistics. Not threadsafe against concurrent access. */
+    void resetStatistics() {
+        _highWater = 0;
+        _lowWater = (size_t)-1;
+        _failedWrites = 0;
+        _failedReads = 0;
+        _droppedBytes = 0;
+    }
+
     jack_ringbuffer_t *_jackRingBuffer;
+    int _bytesPerElement;
+
+    /** Descriptor signalled when the watermark is crossed, or -1. */
+    std::atomic<int> _notificationFd;
+
+    /** Fill level in bytes that triggers a notification. */
+    std::atomic<int> _watermark;
+
+    // Updated by the writing thread.
+    std::atomic<size_t> _highWater;
+    std::atomic<qint64> _failedWrites;
+    std::atomic<qint64> _droppedBytes;
+
+    // Updated by the reading thread.
+    std::atomic<size_t> _lowWater;
+    std::atomic<qint64> _failedReads;
 };
 
 template<typename Type>
 class RingBuffer {
+    friend class RingBufferNotifier;
+    friend class RingBufferMonitor;
 public:
+    /** Contiguous range of elements inside the ring buffer memory. */
+    struct Segment {
+        Segment() : _data(0), _numberOfElements(0) { }
+
+        Type *data() const REALTIME_SAFE { return _data; }
+        int numberOfElements() const REALTIME_SAFE { return _numberOfElements; }
+
+        Type *_data;
+        int _numberOfElements;
+    };
+
+    /**
+     * Elements of the ring buffer accessible in place. When the range wraps
+     * around the end of the ring buffer memory, it continues in the second
+     * segment, otherwise the second segment is empty.
+     */
+    struct Vector {
+        const Segment& first() const REALTIME_SAFE { return _segments[0]; }
+        const Segment& second() const REALTIME_SAFE { return _segments[1]; }
+        const Segment& segment(int i) const REALTIME_SAFE { return _segments[i]; }
+
+        int numberOfElements() const REALTIME_SAFE {
+            return _segments[0]._numberOfElements + _segments[1]._numberOfElements;
+        }
+
+        /** Copies @a count elements to the vector, starting at @a offset. */
+        void copyIn(int offset, const Type *data, int count) const REALTIME_SAFE {
+            for(int i = 0; i < 2 && count > 0; i++) {
+                if(offset >= _segments[i]._numberOfElements) {
+                    offset -= _segments[i]._numberOfElements;
+                    continue;
+                }
+                int chunk = qMin(_segments[i]._numberOfElements - offset, count);
+                memcpy(_segments[i]._data + offset, data, chunk * sizeof(Type));
+                data += chunk;
+                count -= chunk;
+                offset = 0;
+            }
+        }
+
+        /** Copies @a count elements from the vector, starting at @a offset. */
+        void copyOut(int offset, Type *data, int count) const REALTIME_SAFE {
+            for(int i = 0; i < 2 && count > 0; i++) {
+                if(offset >= _segments[i]._numberOfElements) {
+                    offset -= _segments[i]._numberOfElements;
+                    continue;
+                }
+                int chunk = qMin(_segments[i]._numberOfElements - offset, count);
+                memcpy(data, _segments[i]._data + offset, chunk * sizeof(Type));
+                data += chunk;
+                count -= chunk;
+                offset = 0;
+            }
+        }
+
+        Segment _segments[2];
+    };
+
     RingBuffer(int numberOfElements = 4096) {
-        _p = QSharedPointer<RingBufferPrivate>(new RingBufferPrivate(numberOfElements * bytesPerElement()));
+        _p = QSharedPointer<RingBufferPrivate>(new RingBufferPrivate(numberOfElements * bytesPerElement(),
+                                                                     bytesPerElement()));
     }
 
     RingBuffer(const RingBuffer& other) {
@@ -97,6 +303,7 @@ public:
         int bytesRead = jack_ringbuffer_read(_p->_jackRingBuffer,
                                              (char*)data,
                                              numberOfElements * bytesPerElement());
+        _p->recordRead(numberOfElements * bytesPerElement(), bytesRead);
         return bytesRead / bytesPerElement();
     }
 
@@ -105,14 +312,105 @@ public:
         int bytesWritten = jack_ringbuffer_write(_p->_jackRingBuffer,
                                                  (char*)data,
                                                  numberOfElements * bytesPerElement());
+        _p->recordWrite(numberOfElements * bytesPerElement(), bytesWritten);
+        _p->notifyWritten(bytesWritten);
         return bytesWritten / bytesPerElement();
     }
 
+    /**
+     * Reads exactly @a numberOfElements elements, or nothing if not that
+     * many are available.
+     * @returns true on success.
+     */
+    bool readAll(Type *data, int numberOfElements) REALTIME_SAFE {
+        if(numberOfElementsAvailableForRead() < numberOfElements) {
+            _p->recordRead(numberOfElements * bytesPerElement(), 0);
+            return false;
+        }
+        read(data, numberOfElements);
+        return true;
+    }
+
+    /**
+     * Writes exactly @a numberOfElements elements, or nothing if there is
+     * not enough space. Failed writes count as dropped.
+     * @returns true on success.
+     */
+    bool writeAll(Type *data, int numberOfElements) REALTIME_SAFE {
+        if(numberOfElementsCanBeWritten() < numberOfElements) {
+            _p->recordWrite(numberOfElements * bytesPerElement(), 0);
+            return false;
+        }
+        write(data, numberOfElements);
+        return true;
+    }
+
+    /** @returns a snapshot of fill levels and failures. Not a RT operation. */
+    RingBufferStatistics statistics() const {
+        return _p->statistics();
+    }
+
+    /** Resets fill levels and failure counts. @attention Not threadsafe. */
+    void resetStatistics() {
+        _p->resetStatistics();
+    }
+
+    /**
+     * @returns the elements available for reading in place. Only the reading
+     * thread may call this. Consume them with readAdvance().
+     * @attention In-place access requires a power of two element size, so
+     * that no element wraps around the end of the ring buffer memory.
+     * Otherwise the vector is empty.
+     */
+    Vector readVector() const REALTIME_SAFE {
+        jack_ringbuffer_data_t data[2];
+        jack_ringbuffer_get_read_vector(_p->_jackRingBuffer, data);
+        return vector(data);
+    }
+
+    /**
+     * @returns the space available for writing in place. Only the writing
+     * thread may call this. Publish written elements with writeAdvance().
+     * @attention In-place access requires a power of two element size, so
+     * that no element wraps around the end of the ring buffer memory.
+     * Otherwise the vector is empty.
+     */
+    Vector writeVector() REALTIME_SAFE {
+        jack_ringbuffer_data_t data[2];
+        jack_ringbuffer_get_write_vector(_p->_jackRingBuffer, data);
+        return vector(data);
+    }
+
+    /** Marks @a numberOfElements elements as read. */
+    void readAdvance(int numberOfElements) REALTIME_SAFE {
+        jack_ringbuffer_read_advance(_p->_jackRingBuffer, numberOfElements * bytesPerElement());
+        _p->recordRead(numberOfElements * bytesPerElement(), numberOfElements * bytesPerElement());
+    }
+
+    /** Marks @a numberOfElements elements as written. */
+    void writeAdvance(int numberOfElements) REALTIME_SAFE {
+        jack_ringbuffer_write_advance(_p->_jackRingBuffer, numberOfElements * bytesPerElement());
+        _p->recordWrite(numberOfElements * bytesPerElement(), numberOfElements * bytesPerElement());
+        _p->notifyWritten(numberOfElements * bytesPerElement());
+    }
+
     int bytesPerElement() const REALTIME_SAFE {
         return sizeof(Type);
     }
 
 private:
+    static Vector vector(const jack_ringbuffer_data_t *data) REALTIME_SAFE {
+        Vector vector;
+        if((sizeof(Type) & (sizeof(Type) - 1)) != 0) {
+            return vector;
+        }
+        for(int i = 0; i < 2; i++) {
+            vector._segments[i]._data = (Type*)data[i].buf;
+            vector._segments[i]._numberOfElements = (int)(data[i].len / sizeof(Type));
+        }
+        return vector;
+    }
+
     QSharedPointer<RingBufferPrivate> _p;
 };
 
@@ -120,3 +418,16 @@ typedef RingBuffer<AudioSample> AudioRingBuffer;
 typedef RingBuffer<MidiData> MidiRingBuffer;
 
 } // namespace QtJack
+
+Q_DECLARE_METATYPE(QtJack::RingBufferStatistics)
+
+namespace QtJack {
+    class RingBufferStatisticsMetaTypeInitializer {
+    public:
+        RingBufferStatisticsMetaTypeInitializer() {
+            qRegisterMetaType<QtJack::RingBufferStatistics>();
+        }
+    };
+
+    static RingBufferStatisticsMetaTypeInitializer ringBufferStatisticsMetaTypeInitializer;
+} // namespace QtJack
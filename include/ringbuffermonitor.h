@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "ringbuffer.h"
+
+// Qt includes
+#include <QObject>
+#include <QSharedPointer>
+#include <QTimer>
+
+namespace QtJack {
+
+/**
+ * @brief Reports fill levels and failures of a ring buffer to the Qt side.
+ * The ring buffer counts failed reads and writes, dropped elements and its
+ * high- and low-water marks with relaxed atomics, which costs the realtime
+ * thread a few plain loads and stores. This monitor samples those counters
+ * on a timer and emits statisticsChanged() only if they changed, so the
+ * signal fires at most once per polling interval however often the ring
+ * buffer over- or underruns.
+ */
+class RingBufferMonitor : public QObject {
+    Q_OBJECT
+public:
+    template<typename Type>
+    RingBufferMonitor(RingBuffer<Type>& ringBuffer, QObject *parent = 0)
+        : QObject(parent) {
+        initialize(ringBuffer._p);
+    }
+
+    virtual ~RingBufferMonitor();
+
+    /** @returns the statistics as of the last poll. */
+    RingBufferStatistics statistics() const { return _statistics; }
+
+    /** Resets the statistics of the ring buffer. @attention Not threadsafe. */
+    void resetStatistics();
+
+    /** Starts polling every @a milliseconds. */
+    void startPolling(int milliseconds = 250);
+
+    /** Stops polling. */
+    void stopPolling();
+
+public Q_SLOTS:
+    /**
+     * Takes a snapshot of the statistics.
+     * @returns true, if the water marks or failure counts changed.
+     */
+    bool poll();
+
+Q_SIGNALS:
+    /** This signal will be emitted when poll() found changed statistics. */
+    void statisticsChanged(QtJack::RingBufferStatistics statistics);
+
+private:
+    Q_DISABLE_COPY(RingBufferMonitor)
+
+    void initialize(QSharedPointer<RingBufferPrivate> ringBuffer);
+
+    QSharedPointer<RingBufferPrivate> _ringBuffer;
+    RingBufferStatistics _statistics;
+    QTimer _timer;
+};
+
+} // namespace QtJack
@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "ringbuffer.h"
+
+// Qt includes
+#include <QObject>
+#include <QSharedPointer>
+#include <QSocketNotifier>
+
+namespace QtJack {
+
+/**
+ * @brief Wakes up a Qt consumer when a ring buffer fills up.
+ * Whenever a write makes the fill level of the ring buffer rise across the
+ * watermark, the writing thread signals an eventfd (a pipe on systems
+ * without eventfd) without blocking, and watermarkReached() is emitted in
+ * the thread this notifier lives in. Consumers therefore wake up exactly
+ * when there is a block to process instead of polling on a timer.
+ *
+ * The notification is edge triggered: it fires again only after the fill
+ * level dropped below the watermark, so a consumer should read at least
+ * down to the watermark on each notification.
+ *
+ * Create and destroy the notifier while the ring buffer is not being
+ * written to, e.g. before activating or after deactivating the client.
+ */
+class RingBufferNotifier : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * Creates a notifier for @a ringBuffer.
+     * @param watermark Fill level in elements that triggers a notification.
+     */
+    template<typename Type>
+    RingBufferNotifier(RingBuffer<Type>& ringBuffer, int watermark, QObject *parent = 0)
+        : QObject(parent) {
+        initialize(ringBuffer._p, watermark * ringBuffer.bytesPerElement());
+        _bytesPerElement = ringBuffer.bytesPerElement();
+    }
+
+    virtual ~RingBufferNotifier();
+
+    /** @returns true if the notification descriptor could be created. */
+    bool isValid() const { return _readFd >= 0; }
+
+    /** @returns the fill level in elements that triggers a notification. */
+    int watermark() const;
+
+    /** Sets the fill level in elements that triggers a notification. */
+    void setWatermark(int watermark);
+
+Q_SIGNALS:
+    /** Emitted when the fill level of the ring buffer crossed the watermark. */
+    void watermarkReached();
+
+private Q_SLOTS:
+    void drain();
+
+private:
+    Q_DISABLE_COPY(RingBufferNotifier)
+
+    void initialize(QSharedPointer<RingBufferPrivate> ringBuffer, int watermarkBytes);
+
+    QSharedPointer<RingBufferPrivate> _ringBuffer;
+    QSocketNotifier *_socketNotifier;
+    int _bytesPerElement;
+    int _readFd;
+    int _writeFd;
+};
+
+} // namespace QtJack
@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+#include "audiobuffer.h"
+#include "ringbuffer.h"
+
+// Qt includes
+#include <QtGlobal>
+
+namespace QtJack {
+
+/**
+ * @brief Converts between audio buffers and interleaved frames.
+ * Frames leaving the JACK graph, for example to files, sockets or codecs,
+ * are usually interleaved and often integer coded. The converter moves
+ * blocks of samples between a set of channels and interleaved frames of
+ * the configured sample format using vectorized conversion kernels.
+ * Integer formats are rounded to nearest and saturated, and can optionally
+ * be dithered with triangular (TPDF) noise of one LSB.
+ *
+ * A converter keeps the state of its dither generator, so use one
+ * converter per thread.
+ */
+class SampleConverter {
+public:
+    /** Format of interleaved samples, in native byte order. */
+    enum SampleFormat {
+        /** 32 bit floating point. */
+        SampleFormatFloat32,
+        /** 16 bit signed integer. */
+        SampleFormatInt16,
+        /** 24 bit signed integer, packed into three bytes, little endian. */
+        SampleFormatInt24,
+        /** 32 bit signed integer. */
+        SampleFormatInt32
+    };
+
+    SampleConverter(SampleFormat sampleFormat = SampleFormatFloat32, bool dither = false);
+
+    SampleFormat sampleFormat() const REALTIME_SAFE { return _sampleFormat; }
+    void setSampleFormat(SampleFormat sampleFormat) REALTIME_SAFE { _sampleFormat = sampleFormat; }
+
+    /** @returns true, if integer formats are dithered. */
+    bool dither() const REALTIME_SAFE { return _dither; }
+    void setDither(bool dither) REALTIME_SAFE { _dither = dither; }
+
+    /** @returns the number of bytes of a single sample in the given format. */
+    static int bytesPerSample(SampleFormat sampleFormat) REALTIME_SAFE;
+
+    /** @returns the number of bytes of a frame with the given number of channels. */
+    int bytesPerFrame(int numberOfChannels) const REALTIME_SAFE;
+
+    /**
+     * Interleaves @a frames samples of each channel into @a destination,
+     * which must hold frames * bytesPerFrame(numberOfChannels) bytes.
+     * @returns the number of frames written.
+     */
+    int interleave(const AudioSample *const *channels,
+                   int numberOfChannels,
+                   int frames,
+                   void *destination) REALTIME_SAFE;
+
+    /**
+     * Interleaves the given buffers into @a destination. The number of
+     * frames is the size of the smallest buffer.
+     * @returns the number of frames written or -1 if a buffer is invalid.
+     */
+    int interleave(const AudioBuffer *buffers,
+                   int numberOfChannels,
+                   void *destination) REALTIME_SAFE;
+
+    /**
+     * Interleaves the given buffers as 32 bit floating point frames into
+     * @a ringBuffer, regardless of the configured sample format. Only whole
+     * frames are written, straight into the ring buffer memory.
+     * @returns the number of frames written or -1 if a buffer is invalid.
+     */
+    int interleave(const AudioBuffer *buffers,
+                   int numberOfChannels,
+                   AudioRingBuffer& ringBuffer) REALTIME_SAFE;
+
+    /**
+     * Deinterleaves @a frames frames from @a source into the given channels.
+     * @returns the number of frames read.
+     */
+    int deinterleave(const void *source,
+                     int frames,
+                     AudioSample *const *channels,
+                     int numberOfChannels) REALTIME_SAFE;
+
+    /**
+     * Deinterleaves up to @a frames frames from @a source into the given
+     * buffers, limited by the size of the smallest buffer.
+     * @returns the number of frames read or -1 if a buffer is invalid.
+     */
+    int deinterleave(const void *source,
+                     int frames,
+                     AudioBuffer *buffers,
+                     int numberOfChannels) REALTIME_SAFE;
+
+    /**
+     * Deinterleaves 32 bit floating point frames from @a ringBuffer into the
+     * given buffers, regardless of the configured sample format. Reads as
+     * many whole frames as are available and fit into the smallest buffer,
+     * straight from the ring buffer memory.
+     * @returns the number of frames read or -1 if a buffer is invalid.
+     */
+    int deinterleave(AudioRingBuffer& ringBuffer,
+                     AudioBuffer *buffers,
+                     int numberOfChannels) REALTIME_SAFE;
+
+private:
+    /** Number of frames converted per block on the stack. */
+    enum { BlockSize = 256 };
+
+    void storeChannel(const AudioSample *channel, int frames, char *destination,
+                      int stride, SampleFormat sampleFormat);
+    void loadChannel(const char *source, int stride, int frames,
+                     AudioSample *channel, SampleFormat sampleFormat);
+    void generateDither(AudioSample *dither, int count);
+
+    SampleFormat _sampleFormat;
+    bool _dither;
+    quint32 _ditherState;
+};
+
+} // namespace QtJack
@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+
+// Qt includes
+#include <QtGlobal>
+
+// Standard includes
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace QtJack {
+
+/**
+ * @brief Sequence lock publishing a small plain struct, such as a
+ * TransportPosition, from one writer to any number of readers.
+ * The writer never waits: it makes the sequence odd, stores the value and
+ * makes the sequence even again. Readers copy the value and retry if the
+ * sequence was odd or changed meanwhile, so they always get the newest
+ * consistent copy. The value is kept in atomic words, so concurrent
+ * reading and writing is well defined.
+ *
+ * Compared to TripleBuffer this needs no extra copies and supports many
+ * readers, but readers may have to retry while the writer is active, so
+ * it suits small values that are read by non realtime threads.
+ */
+template<typename Type>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<Type>::value,
+                  "SeqLock requires a trivially copyable type");
+public:
+    SeqLock()
+        : _sequence(0) {
+        for(int i = 0; i < NumberOfWords; i++) {
+            _words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /** Publishes @a value. Only one thread may write. */
+    void write(const Type& value) REALTIME_SAFE {
+        quint64 words[NumberOfWords] = { };
+        memcpy(words, &value, sizeof(Type));
+
+        unsigned int sequence = _sequence.load(std::memory_order_relaxed);
+        _sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for(int i = 0; i < NumberOfWords; i++) {
+            _words[i].store(words[i], std::memory_order_relaxed);
+        }
+        _sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * Makes a single attempt to copy the newest value into @a value.
+     * @returns false if the writer interfered, in which case @a value is
+     * unchanged.
+     */
+    bool tryRead(Type& value) const REALTIME_SAFE {
+        unsigned int sequence = _sequence.load(std::memory_order_acquire);
+        if(sequence & 1) {
+            return false;
+        }
+
+        quint64 words[NumberOfWords];
+        for(int i = 0; i < NumberOfWords; i++) {
+            words[i] = _words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(_sequence.load(std::memory_order_relaxed) != sequence) {
+            return false;
+        }
+
+        memcpy(&value, words, sizeof(Type));
+        return true;
+    }
+
+    /** @returns the newest value, retrying while the writer interferes. */
+    Type read() const {
+        Type value;
+        while(!tryRead(value)) {
+        }
+        return value;
+    }
+
+    /** @returns how often a value has been written. */
+    unsigned int numberOfWrites() const REALTIME_SAFE {
+        return _sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    Q_DISABLE_COPY(SeqLock)
+
+    enum { NumberOfWords = (sizeof(Type) + sizeof(quint64) - 1) / sizeof(quint64) };
+
+    std::atomic<unsigned int> _sequence;
+    std::atomic<quint64> _words[NumberOfWords];
+};
+
+} // namespace QtJack
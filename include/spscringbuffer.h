@@ -0,0 +1,258 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+
+// Qt includes
+#include <QtGlobal>
+
+// Standard includes
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace QtJack {
+
+/**
+ * @brief Lock-free single producer, single consumer ring buffer.
+ * Unlike RingBuffer, this is a header-only template that does not depend
+ * on libjack, counts in elements of Type rather than bytes and holds any
+ * copyable or movable element type. Elements are constructed in raw
+ * storage when written and destroyed when read, so Type needs no default
+ * constructor. Bulk operations on trivially copyable types like
+ * AudioSample and MidiData copy at most two contiguous runs. The
+ * capacity is a compile-time power of two, so all index arithmetic reduces
+ * to masking, and the buffer can hold exactly Capacity elements.
+ *
+ * The read and write indices live on separate cache lines. Each side keeps
+ * a cached copy of the other side's index and only reloads it when the
+ * cached value suggests the buffer is full or empty, so in steady state
+ * neither side touches the other's cache line.
+ *
+ * Exactly one thread may write and exactly one thread may read. Element
+ * storage is allocated on construction, so construct the ring buffer
+ * outside of the process thread.
+ */
+template<typename Type, int Capacity>
+class SpscRingBuffer {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+public:
+    SpscRingBuffer()
+        : _storage(new Storage[Capacity]),
+          _writeIndex(0),
+          _cachedReadIndex(0),
+          _readIndex(0),
+          _cachedWriteIndex(0) {
+    }
+
+    ~SpscRingBuffer() {
+        size_t writeIndex = _writeIndex.load(std::memory_order_acquire);
+        for(size_t index = _readIndex.load(std::memory_order_relaxed); index != writeIndex; index++) {
+            element(index)->~Type();
+        }
+        delete[] _storage;
+    }
+
+    /** @returns the number of elements this ring buffer can hold. */
+    static constexpr int capacity() REALTIME_SAFE { return Capacity; }
+
+    /**
+     * @returns how many elements are available for reading. Exact when
+     * called from the reading thread.
+     */
+    int numberOfElementsAvailableForRead() const REALTIME_SAFE {
+        return (int)(_writeIndex.load(std::memory_order_acquire)
+                     - _readIndex.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @returns how many elements are available for writing. Exact when
+     * called from the writing thread.
+     */
+    int numberOfElementsCanBeWritten() const REALTIME_SAFE {
+        return Capacity - (int)(_writeIndex.load(std::memory_order_relaxed)
+                                - _readIndex.load(std::memory_order_acquire));
+    }
+
+    /**
+     * Writes a single element.
+     * @returns false if the ring buffer is full.
+     */
+    bool push(const Type& element) REALTIME_SAFE {
+        size_t writeIndex = _writeIndex.load(std::memory_order_relaxed);
+        if(writeSpace(writeIndex, 1) < 1) {
+            return false;
+        }
+        new (this->element(writeIndex)) Type(element);
+        _writeIndex.store(writeIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Moves a single element into the ring buffer.
+     * @returns false if the ring buffer is full.
+     */
+    bool push(Type&& element) REALTIME_SAFE {
+        size_t writeIndex = _writeIndex.load(std::memory_order_relaxed);
+        if(writeSpace(writeIndex, 1) < 1) {
+            return false;
+        }
+        new (this->element(writeIndex)) Type(std::move(element));
+        _writeIndex.store(writeIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Reads a single element, moving it out of the ring buffer.
+     * @returns false if the ring buffer is empty.
+     */
+    bool pop(Type& element) REALTIME_SAFE {
+        size_t readIndex = _readIndex.load(std::memory_order_relaxed);
+        if(readSpace(readIndex, 1) < 1) {
+            return false;
+        }
+        Type *stored = this->element(readIndex);
+        element = std::move(*stored);
+        stored->~Type();
+        _readIndex.store(readIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Writes up to @a numberOfElements elements from @a data.
+     * @returns the number of elements written.
+     */
+    int write(const Type *data, int numberOfElements) REALTIME_SAFE {
+        size_t writeIndex = _writeIndex.load(std::memory_order_relaxed);
+        numberOfElements = qMin(numberOfElements, writeSpace(writeIndex, numberOfElements));
+        if(numberOfElements <= 0) {
+            return 0;
+        }
+
+        if constexpr(std::is_trivially_copyable<Type>::value) {
+            int firstRun = qMin(numberOfElements, Capacity - (int)(writeIndex & Mask));
+            memcpy(&_storage[writeIndex & Mask], data, firstRun * sizeof(Type));
+            memcpy(&_storage[0], data + firstRun, (numberOfElements - firstRun) * sizeof(Type));
+        } else {
+            for(int i = 0; i < numberOfElements; i++) {
+                new (element(writeIndex + i)) Type(data[i]);
+            }
+        }
+        _writeIndex.store(writeIndex + numberOfElements, std::memory_order_release);
+        return numberOfElements;
+    }
+
+    /**
+     * Reads up to @a numberOfElements elements into @a data, moving them
+     * out of the ring buffer.
+     * @returns the number of elements read.
+     */
+    int read(Type *data, int numberOfElements) REALTIME_SAFE {
+        size_t readIndex = _readIndex.load(std::memory_order_relaxed);
+        numberOfElements = qMin(numberOfElements, readSpace(readIndex, numberOfElements));
+        if(numberOfElements <= 0) {
+            return 0;
+        }
+
+        if constexpr(std::is_trivially_copyable<Type>::value) {
+            int firstRun = qMin(numberOfElements, Capacity - (int)(readIndex & Mask));
+            memcpy(data, &_storage[readIndex & Mask], firstRun * sizeof(Type));
+            memcpy(data + firstRun, &_storage[0], (numberOfElements - firstRun) * sizeof(Type));
+        } else {
+            for(int i = 0; i < numberOfElements; i++) {
+                Type *stored = element(readIndex + i);
+                data[i] = std::move(*stored);
+                stored->~Type();
+            }
+        }
+        _readIndex.store(readIndex + numberOfElements, std::memory_order_release);
+        return numberOfElements;
+    }
+
+private:
+    Q_DISABLE_COPY(SpscRingBuffer)
+
+    enum { Mask = Capacity - 1, CacheLineSize = 64 };
+
+    /** Uninitialized memory for one element. */
+    typedef typename std::aligned_storage<sizeof(Type), alignof(Type)>::type Storage;
+
+    /** @returns the slot of the element at @a index. */
+    Type *element(size_t index) REALTIME_SAFE {
+        return std::launder(reinterpret_cast<Type*>(&_storage[index & Mask]));
+    }
+
+    /**
+     * @returns the space for writing. Reloads the read index only if the
+     * cached copy shows less than @a needed elements of space.
+     */
+    int writeSpace(size_t writeIndex, int needed) REALTIME_SAFE {
+        int space = Capacity - (int)(writeIndex - _cachedReadIndex);
+        if(space < needed) {
+            _cachedReadIndex = _readIndex.load(std::memory_order_acquire);
+            space = Capacity - (int)(writeIndex - _cachedReadIndex);
+        }
+        return space;
+    }
+
+    /**
+     * @returns the number of elements available for reading. Reloads the
+     * write index only if the cached copy shows less than @a needed elements.
+     */
+    int readSpace(size_t readIndex, int needed) REALTIME_SAFE {
+        int space = (int)(_cachedWriteIndex - readIndex);
+        if(space < needed) {
+            _cachedWriteIndex = _writeIndex.load(std::memory_order_acquire);
+            space = (int)(_cachedWriteIndex - readIndex);
+        }
+        return space;
+    }
+
+    Storage *_storage;
+
+    // Written by the producer, read by the consumer.
+    alignas(CacheLineSize) std::atomic<size_t> _writeIndex;
+    size_t _cachedReadIndex;
+
+    // Written by the consumer, read by the producer. The alignment of
+    // these members also pads the object to a whole cache line.
+    alignas(CacheLineSize) std::atomic<size_t> _readIndex;
+    size_t _cachedWriteIndex;
+};
+
+template<int Capacity>
+using AudioSpscRingBuffer = SpscRingBuffer<AudioSample, Capacity>;
+
+template<int Capacity>
+using MidiSpscRingBuffer = SpscRingBuffer<MidiData, Capacity>;
+
+} // namespace QtJack
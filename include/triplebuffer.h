@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+// Own includes
+#include "global.h"
+
+// Qt includes
+#include <QtGlobal>
+
+// Standard includes
+#include <atomic>
+
+namespace QtJack {
+
+/**
+ * @brief Wait-free latest-value buffer between one writer and one reader.
+ * Of three copies of Type, the writer owns one, the reader owns one and
+ * the third is exchanged through a single atomic index. Publishing swaps
+ * the writer's copy with the exchanged one, fetching swaps the reader's
+ * copy with it, so neither side ever waits and the reader always sees the
+ * newest complete value. Values the reader did not fetch in time are
+ * simply replaced; a stalled reader never holds up the writer.
+ *
+ * Exactly one thread may write and exactly one thread may read. Since the
+ * writer gets back an older copy after publishing, it has to fill in the
+ * whole value before each publish().
+ */
+template<typename Type>
+class TripleBuffer {
+public:
+    TripleBuffer()
+        : _writeIndex(0),
+          _readIndex(1),
+          _sharedIndex(2) {
+    }
+
+    /** Initializes all three copies with @a value. */
+    explicit TripleBuffer(const Type& value)
+        : _writeIndex(0),
+          _readIndex(1),
+          _sharedIndex(2) {
+        for(int i = 0; i < 3; i++) {
+            _buffers[i]._value = value;
+        }
+    }
+
+    /** @returns the copy owned by the writer. */
+    Type& writeBuffer() REALTIME_SAFE {
+        return _buffers[_writeIndex]._value;
+    }
+
+    /** Publishes the writer's copy. */
+    void publish() REALTIME_SAFE {
+        int previous = _sharedIndex.exchange(_writeIndex | Fresh, std::memory_order_acq_rel);
+        _writeIndex = previous & IndexMask;
+    }
+
+    /** Copies @a value into the writer's copy and publishes it. */
+    void write(const Type& value) REALTIME_SAFE {
+        writeBuffer() = value;
+        publish();
+    }
+
+    /**
+     * @returns true if a value has been published that the reader has not
+     * fetched yet. May be called from either side.
+     */
+    bool hasUpdate() const REALTIME_SAFE {
+        return (_sharedIndex.load(std::memory_order_acquire) & Fresh) != 0;
+    }
+
+    /**
+     * Fetches the most recently published value, if there is a new one.
+     * @returns true, if readBuffer() changed.
+     */
+    bool update() REALTIME_SAFE {
+        if(!hasUpdate()) {
+            return false;
+        }
+        int previous = _sharedIndex.exchange(_readIndex, std::memory_order_acq_rel);
+        _readIndex = previous & IndexMask;
+        return true;
+    }
+
+    /** @returns the copy owned by the reader, as of the last update(). */
+    const Type& readBuffer() const REALTIME_SAFE {
+        return _buffers[_readIndex]._value;
+    }
+
+    /**
+     * Fetches the most recently published value into @a value.
+     * @returns true, if it has not been read before.
+     */
+    bool read(Type& value) REALTIME_SAFE {
+        bool updated = update();
+        value = readBuffer();
+        return updated;
+    }
+
+private:
+    Q_DISABLE_COPY(TripleBuffer)
+
+    /** Marks the exchanged copy as published but not fetched yet. */
+    enum { Fresh = 4, IndexMask = 3, CacheLineSize = 64 };
+
+    /** Keeps copies owned by different threads on separate cache lines. */
+    struct alignas(CacheLineSize) Buffer {
+        Type _value;
+    };
+
+    Buffer _buffers[3];
+
+    // Owned by the writer.
+    alignas(CacheLineSize) int _writeIndex;
+
+    // Owned by the reader.
+    alignas(CacheLineSize) int _readIndex;
+
+    // Exchanged between both.
+    alignas(CacheLineSize) std::atomic<int> _sharedIndex;
+};
+
+} // namespace QtJack
@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "audioblockringbuffer.h"
+
+namespace QtJack {
+
+AudioBlockRingBuffer::AudioBlockRingBuffer(int numberOfFrames, int framesPerBlock)
+    : _ringBuffer(numberOfFrames * (int)sizeof(AudioSample)
+                  + (numberOfFrames / (framesPerBlock > 0 ? framesPerBlock : 1) + 1)
+                  * (int)sizeof(AudioBlockHeader)) {
+    _sequence = 0;
+    _droppedBlocks = 0;
+}
+
+bool AudioBlockRingBuffer::write(const AudioSample *samples, int frames, quint32 frameTime) {
+    AudioBlockHeader header;
+    header._sequence = _sequence++;
+    header._frameTime = frameTime;
+    header._frames = frames > 0 ? frames : 0;
+
+    int sampleBytes = header._frames * (int)sizeof(AudioSample);
+    ByteRingBuffer::Vector vector = _ringBuffer.writeVector();
+    if(vector.numberOfElements() < (int)sizeof(header) + sampleBytes) {
+        _droppedBlocks.store(_droppedBlocks.load(std::memory_order_relaxed) + 1,
+                             std::memory_order_relaxed);
+        return false;
+    }
+
+    vector.copyIn(0, (const char*)&header, sizeof(header));
+    vector.copyIn(sizeof(header), (const char*)samples, sampleBytes);
+    _ringBuffer.writeAdvance(sizeof(header) + sampleBytes);
+    return true;
+}
+
+bool AudioBlockRingBuffer::peek(AudioBlockHeader& header) const {
+    ByteRingBuffer::Vector vector = _ringBuffer.readVector();
+    if(vector.numberOfElements() < (int)sizeof(header)) {
+        return false;
+    }
+    vector.copyOut(0, (char*)&header, sizeof(header));
+    return true;
+}
+
+bool AudioBlockRingBuffer::read(AudioBlockHeader& header, AudioSample *samples, int maximumFrames) {
+    ByteRingBuffer::Vector vector = _ringBuffer.readVector();
+    if(vector.numberOfElements() < (int)sizeof(header)) {
+        return false;
+    }
+    vector.copyOut(0, (char*)&header, sizeof(header));
+
+    int frames = header._frames < maximumFrames ? header._frames : maximumFrames;
+    if(frames > 0) {
+        vector.copyOut(sizeof(header), (char*)samples, frames * (int)sizeof(AudioSample));
+    }
+    _ringBuffer.readAdvance(sizeof(header) + header._frames * (int)sizeof(AudioSample));
+    return true;
+}
+
+bool AudioBlockRingBuffer::skip() {
+    AudioBlockHeader header;
+    if(!peek(header)) {
+        return false;
+    }
+    _ringBuffer.readAdvance(sizeof(header) + header._frames * (int)sizeof(AudioSample));
+    return true;
+}
+
+quint64 AudioBlockRingBuffer::numberOfDroppedBlocks() const {
+    return _droppedBlocks.load(std::memory_order_relaxed);
+}
+
+} // namespace QtJack
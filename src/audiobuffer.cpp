@@ -23,6 +23,10 @@
 
 // Own includes
 #include "audiobuffer.h"
+#include "audiokernels.h"
+
+// Standard includes
+#include <cmath>
 
 namespace QtJack {
 
@@ -38,6 +42,10 @@ AudioBuffer::AudioBuffer(int size, void *buffer)
     : Buffer(size, buffer) {
 }
 
+AudioBuffer::AudioBuffer(int size, BufferMemory *memory)
+    : Buffer(size, memory) {
+}
+
 AudioBuffer::~AudioBuffer() {
 }
 
@@ -45,9 +53,7 @@ bool AudioBuffer::clear() {
     if(!isValid()) {
         return false;
     }
-    for(int i = 0; i < _size; i++) {
-        ((AudioSample*)_jackBuffer)[i] = 0.0;
-    }
+    AudioKernels::clear((AudioSample*)_jackBuffer, _size);
     return true;
 }
 
@@ -76,39 +82,110 @@ bool AudioBuffer::write(int i, AudioSample value) {
 }
 
 bool AudioBuffer::copyTo(AudioBuffer targetBuffer) const {
-    if(!isValid()) {
+    if(!isValid() || !targetBuffer.isValid()) {
         return false;
     }
 
     int size = _size < targetBuffer.size() ? _size : targetBuffer.size();
-    for(int i = 0; i < size; i++) {
-        ((AudioSample*)targetBuffer._jackBuffer)[i] = ((AudioSample*)_jackBuffer)[i];
-    }
+    AudioKernels::copy((AudioSample*)_jackBuffer, (AudioSample*)targetBuffer._jackBuffer, size);
 
     return true;
 }
 
 bool AudioBuffer::addTo(AudioBuffer targetBuffer) const {
-    if(!isValid()) {
+    if(!isValid() || !targetBuffer.isValid()) {
         return false;
     }
 
     int size = _size < targetBuffer.size() ? _size : targetBuffer.size();
-    for(int i = 0; i < size; i++) {
-        ((AudioSample*)targetBuffer._jackBuffer)[i] += ((AudioSample*)_jackBuffer)[i];
-    }
+    AudioKernels::add((AudioSample*)_jackBuffer, (AudioSample*)targetBuffer._jackBuffer, size);
 
     return true;
 }
 
 bool AudioBuffer::addTo(AudioBuffer targetBuffer, double attenuation) const {
-    if(!isValid()) {
+    if(!isValid() || !targetBuffer.isValid()) {
+        return false;
+    }
+
+    int size = _size < targetBuffer.size() ? _size : targetBuffer.size();
+    AudioKernels::addScaled((AudioSample*)_jackBuffer, (AudioSample*)targetBuffer._jackBuffer, size, (AudioSample)attenuation);
+
+    return true;
+}
+
+bool AudioBuffer::addTo(AudioBuffer targetBuffer,
+                        double startAttenuation,
+                        double endAttenuation,
+                        GainRamp gainRamp) const {
+    if(!isValid() || !targetBuffer.isValid()) {
         return false;
     }
 
     int size = _size < targetBuffer.size() ? _size : targetBuffer.size();
-    for(int i = 0; i < size; i++) {
-        ((AudioSample*)targetBuffer._jackBuffer)[i] += (((AudioSample*)_jackBuffer)[i] * attenuation);
+    if(size <= 0) {
+        return true;
+    }
+
+    if(gainRamp == GainRampExponential && startAttenuation > 0.0 && endAttenuation > 0.0) {
+        AudioKernels::addScaledExponentialRamp((AudioSample*)_jackBuffer,
+                                               (AudioSample*)targetBuffer._jackBuffer,
+                                               size,
+                                               (AudioSample)startAttenuation,
+                                               (AudioSample)pow(endAttenuation / startAttenuation, 1.0 / size));
+    } else {
+        AudioKernels::addScaledRamp((AudioSample*)_jackBuffer,
+                                    (AudioSample*)targetBuffer._jackBuffer,
+                                    size,
+                                    (AudioSample)startAttenuation,
+                                    (AudioSample)((endAttenuation - startAttenuation) / size));
+    }
+
+    return true;
+}
+
+bool AudioBuffer::mix(const AudioBuffer *sourceBuffers,
+                      const double *gains,
+                      int numberOfSources,
+                      MixMode mixMode) {
+    if(!isValid() || numberOfSources < 0) {
+        return false;
+    }
+
+    int size = _size;
+    for(int i = 0; i < numberOfSources; i++) {
+        if(sourceBuffers[i].isValid() && sourceBuffers[i].size() < size) {
+            size = sourceBuffers[i].size();
+        }
+    }
+
+    // Sources are gathered in chunks on the stack, so that no allocation
+    // takes place. Only mixes of more than maximumChunk sources touch the
+    // target more than once.
+    const int maximumChunk = 32;
+    const AudioSample *sources[maximumChunk];
+    AudioSample sourceGains[maximumChunk];
+
+    bool accumulate = (mixMode == MixModeAccumulate);
+    int chunk = 0;
+    for(int i = 0; i < numberOfSources; i++) {
+        if(!sourceBuffers[i].isValid()) {
+            continue;
+        }
+
+        sources[chunk] = (const AudioSample*)sourceBuffers[i]._jackBuffer;
+        sourceGains[chunk] = gains ? (AudioSample)gains[i] : 1.0f;
+        chunk++;
+
+        if(chunk == maximumChunk) {
+            AudioKernels::mix(sources, sourceGains, chunk, (AudioSample*)_jackBuffer, size, accumulate);
+            accumulate = true;
+            chunk = 0;
+        }
+    }
+
+    if(chunk > 0 || !accumulate) {
+        AudioKernels::mix(sources, sourceGains, chunk, (AudioSample*)_jackBuffer, size, accumulate);
     }
 
     return true;
@@ -119,25 +196,67 @@ void AudioBuffer::multiply(double attenuation) {
         return;
     }
 
-    for(int i = 0; i < _size; i++) {
-        ((AudioSample*)_jackBuffer)[i] *= attenuation;
+    AudioKernels::scale((AudioSample*)_jackBuffer, _size, (AudioSample)attenuation);
+}
+
+void AudioBuffer::multiply(double startAttenuation,
+                           double endAttenuation,
+                           GainRamp gainRamp) {
+    if(!isValid() || _size <= 0) {
+        return;
+    }
+
+    if(gainRamp == GainRampExponential && startAttenuation > 0.0 && endAttenuation > 0.0) {
+        AudioKernels::scaleExponentialRamp((AudioSample*)_jackBuffer,
+                                           _size,
+                                           (AudioSample)startAttenuation,
+                                           (AudioSample)pow(endAttenuation / startAttenuation, 1.0 / _size));
+    } else {
+        AudioKernels::scaleRamp((AudioSample*)_jackBuffer,
+                                _size,
+                                (AudioSample)startAttenuation,
+                                (AudioSample)((endAttenuation - startAttenuation) / _size));
     }
 }
 
 bool AudioBuffer::push(AudioRingBuffer &ringBuffer) {
-    if(_size <= ringBuffer.numberOfElementsCanBeWritten()) {
-        ringBuffer.write((AudioSample*)_jackBuffer, _size);
-        return true;
-    }
-    return false;
+    return ringBuffer.writeAll((AudioSample*)_jackBuffer, _size);
 }
 
 bool AudioBuffer::pop(AudioRingBuffer &ringBuffer) {
-    if(ringBuffer.numberOfElementsAvailableForRead() >= _size) {
-        ringBuffer.read((AudioSample*)_jackBuffer, _size);
-        return true;
+    return ringBuffer.readAll((AudioSample*)_jackBuffer, _size);
+}
+
+bool AudioBuffer::push(AudioBroadcastRingBuffer &ringBuffer) {
+    if(!isValid()) {
+        return false;
     }
-    return false;
+    ringBuffer.write((const AudioSample*)_jackBuffer, _size);
+    return true;
+}
+
+bool AudioBuffer::pop(AudioBroadcastRingBuffer::Reader &reader) {
+    if(!isValid() || reader.numberOfElementsAvailableForRead() < _size) {
+        return false;
+    }
+    return reader.read((AudioSample*)_jackBuffer, _size) == _size;
+}
+
+bool AudioBuffer::push(AudioBlockRingBuffer &ringBuffer, quint32 frameTime) {
+    if(!isValid()) {
+        return false;
+    }
+    return ringBuffer.write((const AudioSample*)_jackBuffer, _size, frameTime);
+}
+
+bool AudioBuffer::pop(AudioBlockRingBuffer &ringBuffer, AudioBlockHeader &header) {
+    if(!isValid() || !ringBuffer.read(header, (AudioSample*)_jackBuffer, _size)) {
+        return false;
+    }
+    if(header.frames() < _size) {
+        AudioKernels::clear((AudioSample*)_jackBuffer + header.frames(), _size - header.frames());
+    }
+    return true;
 }
 
 } // namespace QtJack
@@ -0,0 +1,1015 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "audiokernels.h"
+
+// Standard includes
+#include <cmath>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define QTJACK_KERNELS_X86
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define QTJACK_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace QtJack {
+namespace AudioKernels {
+
+// Scalar reference implementation. All vectorized variants below perform
+// the same single precision operations in the same order per sample, so
+// they produce bit-identical results (this file is built without
+// floating point contraction).
+
+static void addScalar(const AudioSample *source, AudioSample *target, int count) {
+    for(int i = 0; i < count; i++) {
+        target[i] += source[i];
+    }
+}
+
+static void addScaledScalar(const AudioSample *source, AudioSample *target, int count, AudioSample gain) {
+    for(int i = 0; i < count; i++) {
+        target[i] += source[i] * gain;
+    }
+}
+
+static void scaleScalar(AudioSample *target, int count, AudioSample gain) {
+    for(int i = 0; i < count; i++) {
+        target[i] *= gain;
+    }
+}
+
+static void mixRange(const AudioSample *const *sources, const AudioSample *gains, int numberOfSources,
+                     AudioSample *target, int begin, int end, bool accumulate) {
+    for(int i = begin; i < end; i++) {
+        AudioSample sum = accumulate ? target[i] : 0.0f;
+        for(int s = 0; s < numberOfSources; s++) {
+            sum += sources[s][i] * gains[s];
+        }
+        target[i] = sum;
+    }
+}
+
+static void mixScalar(const AudioSample *const *sources, const AudioSample *gains, int numberOfSources,
+                      AudioSample *target, int count, bool accumulate) {
+    mixRange(sources, gains, numberOfSources, target, 0, count, accumulate);
+}
+
+// Gain ramps. A linear ramp computes the gain of sample i directly as
+// startGain + i * increment, so it does not depend on the vector width
+// (sample indices are exact in single precision for any buffer size).
+// Exponential ramps are evaluated in blocks of RampBlock samples: the
+// gain of each block is advanced by a constant block ratio and multiplied
+// with per-sample factors, identically for all instruction sets.
+
+enum { RampBlock = 16 };
+
+static void scaleRampScalar(AudioSample *target, int count, AudioSample startGain, AudioSample increment) {
+    for(int i = 0; i < count; i++) {
+        target[i] *= startGain + (AudioSample)i * increment;
+    }
+}
+
+static void addScaledRampScalar(const AudioSample *source, AudioSample *target, int count,
+                                AudioSample startGain, AudioSample increment) {
+    for(int i = 0; i < count; i++) {
+        target[i] += source[i] * (startGain + (AudioSample)i * increment);
+    }
+}
+
+static void scaleExponentialRampScalar(AudioSample *target, int count, AudioSample startGain,
+                                       const AudioSample *factors, AudioSample blockRatio) {
+    AudioSample blockGain = startGain;
+    for(int i = 0; i < count; i += RampBlock) {
+        int blockSize = count - i < RampBlock ? count - i : RampBlock;
+        for(int j = 0; j < blockSize; j++) {
+            target[i + j] *= blockGain * factors[j];
+        }
+        blockGain *= blockRatio;
+    }
+}
+
+static void addScaledExponentialRampScalar(const AudioSample *source, AudioSample *target, int count,
+                                           AudioSample startGain, const AudioSample *factors,
+                                           AudioSample blockRatio) {
+    AudioSample blockGain = startGain;
+    for(int i = 0; i < count; i += RampBlock) {
+        int blockSize = count - i < RampBlock ? count - i : RampBlock;
+        for(int j = 0; j < blockSize; j++) {
+            target[i + j] += source[i + j] * (blockGain * factors[j]);
+        }
+        blockGain *= blockRatio;
+    }
+}
+
+// Sample format conversion. Conversions to integers round to nearest and
+// saturate, vectorized variants rely on the same default rounding mode.
+
+static void toIntegerScalar(const AudioSample *source, int32_t *target, int count, AudioSample scale,
+                            AudioSample minimum, AudioSample maximum, const AudioSample *dither) {
+    for(int i = 0; i < count; i++) {
+        AudioSample value = source[i] * scale;
+        if(dither) {
+            value += dither[i];
+        }
+        value = value > minimum ? value : minimum;
+        value = value < maximum ? value : maximum;
+        target[i] = (int32_t)lrintf(value);
+    }
+}
+
+static void fromIntegerScalar(const int32_t *source, AudioSample *target, int count, AudioSample scale) {
+    for(int i = 0; i < count; i++) {
+        target[i] = (AudioSample)source[i] * scale;
+    }
+}
+
+// Metering. Squares are summed into MeasureLanes partial sums, sample i
+// going to partial i % MeasureLanes, which every variant reduces in the
+// same order afterwards.
+
+enum { MeasureLanes = 16 };
+
+static int measureScalar(const AudioSample *source, int count, AudioSample clipLevel,
+                         AudioSample *peak, AudioSample *partials) {
+    AudioSample maximum = *peak;
+    int clips = 0;
+    for(int i = 0; i < count; i++) {
+        AudioSample value = fabsf(source[i]);
+        maximum = value > maximum ? value : maximum;
+        partials[i % MeasureLanes] += source[i] * source[i];
+        clips += value >= clipLevel ? 1 : 0;
+    }
+    *peak = maximum;
+    return clips;
+}
+
+#if defined(QTJACK_KERNELS_X86)
+
+__attribute__((target("sse2")))
+static void addSse2(const AudioSample *source, AudioSample *target, int count) {
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m128 a = _mm_add_ps(_mm_loadu_ps(target + i),     _mm_loadu_ps(source + i));
+        __m128 b = _mm_add_ps(_mm_loadu_ps(target + i + 4), _mm_loadu_ps(source + i + 4));
+        _mm_storeu_ps(target + i,     a);
+        _mm_storeu_ps(target + i + 4, b);
+    }
+    addScalar(source + i, target + i, count - i);
+}
+
+__attribute__((target("sse2")))
+static void addScaledSse2(const AudioSample *source, AudioSample *target, int count, AudioSample gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m128 a = _mm_add_ps(_mm_loadu_ps(target + i),     _mm_mul_ps(_mm_loadu_ps(source + i),     g));
+        __m128 b = _mm_add_ps(_mm_loadu_ps(target + i + 4), _mm_mul_ps(_mm_loadu_ps(source + i + 4), g));
+        _mm_storeu_ps(target + i,     a);
+        _mm_storeu_ps(target + i + 4, b);
+    }
+    addScaledScalar(source + i, target + i, count - i, gain);
+}
+
+__attribute__((target("sse2")))
+static void scaleSse2(AudioSample *target, int count, AudioSample gain) {
+    const __m128 g = _mm_set1_ps(gain);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        _mm_storeu_ps(target + i,     _mm_mul_ps(_mm_loadu_ps(target + i),     g));
+        _mm_storeu_ps(target + i + 4, _mm_mul_ps(_mm_loadu_ps(target + i + 4), g));
+    }
+    scaleScalar(target + i, count - i, gain);
+}
+
+__attribute__((target("sse2")))
+static void mixSse2(const AudioSample *const *sources, const AudioSample *gains, int numberOfSources,
+                    AudioSample *target, int count, bool accumulate) {
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m128 a = accumulate ? _mm_loadu_ps(target + i)     : _mm_setzero_ps();
+        __m128 b = accumulate ? _mm_loadu_ps(target + i + 4) : _mm_setzero_ps();
+        for(int s = 0; s < numberOfSources; s++) {
+            const __m128 g = _mm_set1_ps(gains[s]);
+            a = _mm_add_ps(a, _mm_mul_ps(_mm_loadu_ps(sources[s] + i),     g));
+            b = _mm_add_ps(b, _mm_mul_ps(_mm_loadu_ps(sources[s] + i + 4), g));
+        }
+        _mm_storeu_ps(target + i,     a);
+        _mm_storeu_ps(target + i + 4, b);
+    }
+    mixRange(sources, gains, numberOfSources, target, i, count, accumulate);
+}
+
+__attribute__((target("sse2")))
+static void scaleRampSse2(AudioSample *target, int count, AudioSample startGain, AudioSample increment) {
+    const __m128 start = _mm_set1_ps(startGain);
+    const __m128 step = _mm_set1_ps(increment);
+    const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m128 ga = _mm_add_ps(start, _mm_mul_ps(_mm_add_ps(_mm_set1_ps((AudioSample)i),       lanes), step));
+        __m128 gb = _mm_add_ps(start, _mm_mul_ps(_mm_add_ps(_mm_set1_ps((AudioSample)(i + 4)), lanes), step));
+        _mm_storeu_ps(target + i,     _mm_mul_ps(_mm_loadu_ps(target + i),     ga));
+        _mm_storeu_ps(target + i + 4, _mm_mul_ps(_mm_loadu_ps(target + i + 4), gb));
+    }
+    for(; i < count; i++) {
+        target[i] *= startGain + (AudioSample)i * increment;
+    }
+}
+
+__attribute__((target("sse2")))
+static void addScaledRampSse2(const AudioSample *source, AudioSample *target, int count,
+                              AudioSample startGain, AudioSample increment) {
+    const __m128 start = _mm_set1_ps(startGain);
+    const __m128 step = _mm_set1_ps(increment);
+    const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m128 ga = _mm_add_ps(start, _mm_mul_ps(_mm_add_ps(_mm_set1_ps((AudioSample)i),       lanes), step));
+        __m128 gb = _mm_add_ps(start, _mm_mul_ps(_mm_add_ps(_mm_set1_ps((AudioSample)(i + 4)), lanes), step));
+        _mm_storeu_ps(target + i,     _mm_add_ps(_mm_loadu_ps(target + i),     _mm_mul_ps(_mm_loadu_ps(source + i),     ga)));
+        _mm_storeu_ps(target + i + 4, _mm_add_ps(_mm_loadu_ps(target + i + 4), _mm_mul_ps(_mm_loadu_ps(source + i + 4), gb)));
+    }
+    for(; i < count; i++) {
+        target[i] += source[i] * (startGain + (AudioSample)i * increment);
+    }
+}
+
+__attribute__((target("sse2")))
+static void scaleExponentialRampSse2(AudioSample *target, int count, AudioSample startGain,
+                                     const AudioSample *factors, AudioSample blockRatio) {
+    const __m128 f0 = _mm_loadu_ps(factors);
+    const __m128 f1 = _mm_loadu_ps(factors + 4);
+    const __m128 f2 = _mm_loadu_ps(factors + 8);
+    const __m128 f3 = _mm_loadu_ps(factors + 12);
+    AudioSample blockGain = startGain;
+    int i = 0;
+    for(; i + RampBlock <= count; i += RampBlock) {
+        const __m128 g = _mm_set1_ps(blockGain);
+        _mm_storeu_ps(target + i,      _mm_mul_ps(_mm_loadu_ps(target + i),      _mm_mul_ps(g, f0)));
+        _mm_storeu_ps(target + i + 4,  _mm_mul_ps(_mm_loadu_ps(target + i + 4),  _mm_mul_ps(g, f1)));
+        _mm_storeu_ps(target + i + 8,  _mm_mul_ps(_mm_loadu_ps(target + i + 8),  _mm_mul_ps(g, f2)));
+        _mm_storeu_ps(target + i + 12, _mm_mul_ps(_mm_loadu_ps(target + i + 12), _mm_mul_ps(g, f3)));
+        blockGain *= blockRatio;
+    }
+    scaleExponentialRampScalar(target + i, count - i, blockGain, factors, blockRatio);
+}
+
+__attribute__((target("sse2")))
+static void addScaledExponentialRampSse2(const AudioSample *source, AudioSample *target, int count,
+                                         AudioSample startGain, const AudioSample *factors,
+                                         AudioSample blockRatio) {
+    const __m128 f0 = _mm_loadu_ps(factors);
+    const __m128 f1 = _mm_loadu_ps(factors + 4);
+    const __m128 f2 = _mm_loadu_ps(factors + 8);
+    const __m128 f3 = _mm_loadu_ps(factors + 12);
+    AudioSample blockGain = startGain;
+    int i = 0;
+    for(; i + RampBlock <= count; i += RampBlock) {
+        const __m128 g = _mm_set1_ps(blockGain);
+        _mm_storeu_ps(target + i,      _mm_add_ps(_mm_loadu_ps(target + i),      _mm_mul_ps(_mm_loadu_ps(source + i),      _mm_mul_ps(g, f0))));
+        _mm_storeu_ps(target + i + 4,  _mm_add_ps(_mm_loadu_ps(target + i + 4),  _mm_mul_ps(_mm_loadu_ps(source + i + 4),  _mm_mul_ps(g, f1))));
+        _mm_storeu_ps(target + i + 8,  _mm_add_ps(_mm_loadu_ps(target + i + 8),  _mm_mul_ps(_mm_loadu_ps(source + i + 8),  _mm_mul_ps(g, f2))));
+        _mm_storeu_ps(target + i + 12, _mm_add_ps(_mm_loadu_ps(target + i + 12), _mm_mul_ps(_mm_loadu_ps(source + i + 12), _mm_mul_ps(g, f3))));
+        blockGain *= blockRatio;
+    }
+    addScaledExponentialRampScalar(source + i, target + i, count - i, blockGain, factors, blockRatio);
+}
+
+__attribute__((target("sse2")))
+static void toIntegerSse2(const AudioSample *source, int32_t *target, int count, AudioSample scale,
+                          AudioSample minimum, AudioSample maximum, const AudioSample *dither) {
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128 lower = _mm_set1_ps(minimum);
+    const __m128 upper = _mm_set1_ps(maximum);
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        __m128 value = _mm_mul_ps(_mm_loadu_ps(source + i), s);
+        if(dither) {
+            value = _mm_add_ps(value, _mm_loadu_ps(dither + i));
+        }
+        value = _mm_min_ps(_mm_max_ps(value, lower), upper);
+        _mm_storeu_si128((__m128i*)(target + i), _mm_cvtps_epi32(value));
+    }
+    toIntegerScalar(source + i, target + i, count - i, scale, minimum, maximum, dither ? dither + i : 0);
+}
+
+__attribute__((target("sse2")))
+static void fromIntegerSse2(const int32_t *source, AudioSample *target, int count, AudioSample scale) {
+    const __m128 s = _mm_set1_ps(scale);
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        __m128 value = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(source + i)));
+        _mm_storeu_ps(target + i, _mm_mul_ps(value, s));
+    }
+    fromIntegerScalar(source + i, target + i, count - i, scale);
+}
+
+__attribute__((target("sse2")))
+static int measureSse2(const AudioSample *source, int count, AudioSample clipLevel,
+                       AudioSample *peak, AudioSample *partials) {
+    const __m128 absolute = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 clip = _mm_set1_ps(clipLevel);
+    __m128 sums[4];
+    for(int k = 0; k < 4; k++) {
+        sums[k] = _mm_loadu_ps(partials + 4 * k);
+    }
+    __m128 maximum = _mm_set1_ps(*peak);
+    __m128i clips = _mm_setzero_si128();
+    int i = 0;
+    for(; i + MeasureLanes <= count; i += MeasureLanes) {
+        for(int k = 0; k < 4; k++) {
+            __m128 value = _mm_loadu_ps(source + i + 4 * k);
+            __m128 magnitude = _mm_and_ps(value, absolute);
+            maximum = _mm_max_ps(magnitude, maximum);
+            sums[k] = _mm_add_ps(sums[k], _mm_mul_ps(value, value));
+            clips = _mm_sub_epi32(clips, _mm_castps_si128(_mm_cmpge_ps(magnitude, clip)));
+        }
+    }
+    AudioSample maxima[4];
+    int32_t counts[4];
+    _mm_storeu_ps(maxima, maximum);
+    _mm_storeu_si128((__m128i*)counts, clips);
+    for(int k = 0; k < 4; k++) {
+        _mm_storeu_ps(partials + 4 * k, sums[k]);
+        *peak = maxima[k] > *peak ? maxima[k] : *peak;
+    }
+    return counts[0] + counts[1] + counts[2] + counts[3]
+         + measureScalar(source + i, count - i, clipLevel, peak, partials);
+}
+
+__attribute__((target("avx2")))
+static void addAvx2(const AudioSample *source, AudioSample *target, int count) {
+    int i = 0;
+    for(; i + 16 <= count; i += 16) {
+        __m256 a = _mm256_add_ps(_mm256_loadu_ps(target + i),     _mm256_loadu_ps(source + i));
+        __m256 b = _mm256_add_ps(_mm256_loadu_ps(target + i + 8), _mm256_loadu_ps(source + i + 8));
+        _mm256_storeu_ps(target + i,     a);
+        _mm256_storeu_ps(target + i + 8, b);
+    }
+    addScalar(source + i, target + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void addScaledAvx2(const AudioSample *source, AudioSample *target, int count, AudioSample gain) {
+    const __m256 g = _mm256_set1_ps(gain);
+    int i = 0;
+    for(; i + 16 <= count; i += 16) {
+        __m256 a = _mm256_add_ps(_mm256_loadu_ps(target + i),     _mm256_mul_ps(_mm256_loadu_ps(source + i),     g));
+        __m256 b = _mm256_add_ps(_mm256_loadu_ps(target + i + 8), _mm256_mul_ps(_mm256_loadu_ps(source + i + 8), g));
+        _mm256_storeu_ps(target + i,     a);
+        _mm256_storeu_ps(target + i + 8, b);
+    }
+    addScaledScalar(source + i, target + i, count - i, gain);
+}
+
+__attribute__((target("avx2")))
+static void scaleAvx2(AudioSample *target, int count, AudioSample gain) {
+    const __m256 g = _mm256_set1_ps(gain);
+    int i = 0;
+    for(; i + 16 <= count; i += 16) {
+        _mm256_storeu_ps(target + i,     _mm256_mul_ps(_mm256_loadu_ps(target + i),     g));
+        _mm256_storeu_ps(target + i + 8, _mm256_mul_ps(_mm256_loadu_ps(target + i + 8), g));
+    }
+    scaleScalar(target + i, count - i, gain);
+}
+
+__attribute__((target("avx2")))
+static void mixAvx2(const AudioSample *const *sources, const AudioSample *gains, int numberOfSources,
+                    AudioSample *target, int count, bool accumulate) {
+    int i = 0;
+    for(; i + 16 <= count; i += 16) {
+        __m256 a = accumulate ? _mm256_loadu_ps(target + i)     : _mm256_setzero_ps();
+        __m256 b = accumulate ? _mm256_loadu_ps(target + i + 8) : _mm256_setzero_ps();
+        for(int s = 0; s < numberOfSources; s++) {
+            const __m256 g = _mm256_set1_ps(gains[s]);
+            a = _mm256_add_ps(a, _mm256_mul_ps(_mm256_loadu_ps(sources[s] + i),     g));
+            b = _mm256_add_ps(b, _mm256_mul_ps(_mm256_loadu_ps(sources[s] + i + 8), g));
+        }
+        _mm256_storeu_ps(target + i,     a);
+        _mm256_storeu_ps(target + i + 8, b);
+    }
+    mixRange(sources, gains, numberOfSources, target, i, count, accumulate);
+}
+
+__attribute__((target("avx2")))
+static void scaleRampAvx2(AudioSample *target, int count, AudioSample startGain, AudioSample increment) {
+    const __m256 start = _mm256_set1_ps(startGain);
+    const __m256 step = _mm256_set1_ps(increment);
+    const __m256 lanes = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    int i = 0;
+    for(; i + 16 <= count; i += 16) {
+        __m256 ga = _mm256_add_ps(start, _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps((AudioSample)i),       lanes), step));
+        __m256 gb = _mm256_add_ps(start, _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps((AudioSample)(i + 8)), lanes), step));
+        _mm256_storeu_ps(target + i,     _mm256_mul_ps(_mm256_loadu_ps(target + i),     ga));
+        _mm256_storeu_ps(target + i + 8, _mm256_mul_ps(_mm256_loadu_ps(target + i + 8), gb));
+    }
+    for(; i < count; i++) {
+        target[i] *= startGain + (AudioSample)i * increment;
+    }
+}
+
+__attribute__((target("avx2")))
+static void addScaledRampAvx2(const AudioSample *source, AudioSample *target, int count,
+                              AudioSample startGain, AudioSample increment) {
+    const __m256 start = _mm256_set1_ps(startGain);
+    const __m256 step = _mm256_set1_ps(increment);
+    const __m256 lanes = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    int i = 0;
+    for(; i + 16 <= count; i += 16) {
+        __m256 ga = _mm256_add_ps(start, _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps((AudioSample)i),       lanes), step));
+        __m256 gb = _mm256_add_ps(start, _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps((AudioSample)(i + 8)), lanes), step));
+        _mm256_storeu_ps(target + i,     _mm256_add_ps(_mm256_loadu_ps(target + i),     _mm256_mul_ps(_mm256_loadu_ps(source + i),     ga)));
+        _mm256_storeu_ps(target + i + 8, _mm256_add_ps(_mm256_loadu_ps(target + i + 8), _mm256_mul_ps(_mm256_loadu_ps(source + i + 8), gb)));
+    }
+    for(; i < count; i++) {
+        target[i] += source[i] * (startGain + (AudioSample)i * increment);
+    }
+}
+
+__attribute__((target("avx2")))
+static void scaleExponentialRampAvx2(AudioSample *target, int count, AudioSample startGain,
+                                     const AudioSample *factors, AudioSample blockRatio) {
+    const __m256 f0 = _mm256_loadu_ps(factors);
+    const __m256 f1 = _mm256_loadu_ps(factors + 8);
+    AudioSample blockGain = startGain;
+    int i = 0;
+    for(; i + RampBlock <= count; i += RampBlock) {
+        const __m256 g = _mm256_set1_ps(blockGain);
+        _mm256_storeu_ps(target + i,     _mm256_mul_ps(_mm256_loadu_ps(target + i),     _mm256_mul_ps(g, f0)));
+        _mm256_storeu_ps(target + i + 8, _mm256_mul_ps(_mm256_loadu_ps(target + i + 8), _mm256_mul_ps(g, f1)));
+        blockGain *= blockRatio;
+    }
+    scaleExponentialRampScalar(target + i, count - i, blockGain, factors, blockRatio);
+}
+
+__attribute__((target("avx2")))
+static void addScaledExponentialRampAvx2(const AudioSample *source, AudioSample *target, int count,
+                                         AudioSample startGain, const AudioSample *factors,
+                                         AudioSample blockRatio) {
+    const __m256 f0 = _mm256_loadu_ps(factors);
+    const __m256 f1 = _mm256_loadu_ps(factors + 8);
+    AudioSample blockGain = startGain;
+    int i = 0;
+    for(; i + RampBlock <= count; i += RampBlock) {
+        const __m256 g = _mm256_set1_ps(blockGain);
+        _mm256_storeu_ps(target + i,     _mm256_add_ps(_mm256_loadu_ps(target + i),     _mm256_mul_ps(_mm256_loadu_ps(source + i),     _mm256_mul_ps(g, f0))));
+        _mm256_storeu_ps(target + i + 8, _mm256_add_ps(_mm256_loadu_ps(target + i + 8), _mm256_mul_ps(_mm256_loadu_ps(source + i + 8), _mm256_mul_ps(g, f1))));
+        blockGain *= blockRatio;
+    }
+    addScaledExponentialRampScalar(source + i, target + i, count - i, blockGain, factors, blockRatio);
+}
+
+__attribute__((target("avx2")))
+static void toIntegerAvx2(const AudioSample *source, int32_t *target, int count, AudioSample scale,
+                          AudioSample minimum, AudioSample maximum, const AudioSample *dither) {
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m256 lower = _mm256_set1_ps(minimum);
+    const __m256 upper = _mm256_set1_ps(maximum);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m256 value = _mm256_mul_ps(_mm256_loadu_ps(source + i), s);
+        if(dither) {
+            value = _mm256_add_ps(value, _mm256_loadu_ps(dither + i));
+        }
+        value = _mm256_min_ps(_mm256_max_ps(value, lower), upper);
+        _mm256_storeu_si256((__m256i*)(target + i), _mm256_cvtps_epi32(value));
+    }
+    toIntegerScalar(source + i, target + i, count - i, scale, minimum, maximum, dither ? dither + i : 0);
+}
+
+__attribute__((target("avx2")))
+static void fromIntegerAvx2(const int32_t *source, AudioSample *target, int count, AudioSample scale) {
+    const __m256 s = _mm256_set1_ps(scale);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m256 value = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(source + i)));
+        _mm256_storeu_ps(target + i, _mm256_mul_ps(value, s));
+    }
+    fromIntegerScalar(source + i, target + i, count - i, scale);
+}
+
+__attribute__((target("avx2")))
+static int measureAvx2(const AudioSample *source, int count, AudioSample clipLevel,
+                       AudioSample *peak, AudioSample *partials) {
+    const __m256 absolute = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 clip = _mm256_set1_ps(clipLevel);
+    __m256 sums[2];
+    for(int k = 0; k < 2; k++) {
+        sums[k] = _mm256_loadu_ps(partials + 8 * k);
+    }
+    __m256 maximum = _mm256_set1_ps(*peak);
+    __m256i clips = _mm256_setzero_si256();
+    int i = 0;
+    for(; i + MeasureLanes <= count; i += MeasureLanes) {
+        for(int k = 0; k < 2; k++) {
+            __m256 value = _mm256_loadu_ps(source + i + 8 * k);
+            __m256 magnitude = _mm256_and_ps(value, absolute);
+            maximum = _mm256_max_ps(magnitude, maximum);
+            sums[k] = _mm256_add_ps(sums[k], _mm256_mul_ps(value, value));
+            clips = _mm256_sub_epi32(clips, _mm256_castps_si256(_mm256_cmp_ps(magnitude, clip, _CMP_GE_OQ)));
+        }
+    }
+    AudioSample maxima[8];
+    int32_t counts[8];
+    _mm256_storeu_ps(maxima, maximum);
+    _mm256_storeu_si256((__m256i*)counts, clips);
+    int total = 0;
+    for(int k = 0; k < 8; k++) {
+        *peak = maxima[k] > *peak ? maxima[k] : *peak;
+        total += counts[k];
+    }
+    for(int k = 0; k < 2; k++) {
+        _mm256_storeu_ps(partials + 8 * k, sums[k]);
+    }
+    return total + measureScalar(source + i, count - i, clipLevel, peak, partials);
+}
+
+__attribute__((target("avx512f")))
+static void addAvx512(const AudioSample *source, AudioSample *target, int count) {
+    int i = 0;
+    for(; i + 16 <= count; i += 16) {
+        _mm512_storeu_ps(target + i, _mm512_add_ps(_mm512_loadu_ps(target + i), _mm512_loadu_ps(source + i)));
+    }
+    if(i < count) {
+        __mmask16 mask = (__mmask16)((1u << (count - i)) - 1);
+        __m512 a = _mm512_add_ps(_mm512_maskz_loadu_ps(mask, target + i), _mm512_maskz_loadu_ps(mask, source + i));
+        _mm512_mask_storeu_ps(target + i, mask, a);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void addScaledAvx512(const AudioSample *source, AudioSample *target, int count, AudioSample gain) {
+    const __m512 g = _mm512_set1_ps(gain);
+    int i = 0;
+    for(; i + 16 <= count; i += 16) {
+        __m512 a = _mm512_add_ps(_mm512_loadu_ps(target + i), _mm512_mul_ps(_mm512_loadu_ps(source + i), g));
+        _mm512_storeu_ps(target + i, a);
+    }
+    if(i < count) {
+        __mmask16 mask = (__mmask16)((1u << (count - i)) - 1);
+        __m512 a = _mm512_add_ps(_mm512_maskz_loadu_ps(mask, target + i),
+                                 _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, source + i), g));
+        _mm512_mask_storeu_ps(target + i, mask, a);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void scaleAvx512(AudioSample *target, int count, AudioSample gain) {
+    const __m512 g = _mm512_set1_ps(gain);
+    int i = 0;
+    for(; i + 16 <= count; i += 16) {
+        _mm512_storeu_ps(target + i, _mm512_mul_ps(_mm512_loadu_ps(target + i), g));
+    }
+    if(i < count) {
+        __mmask16 mask = (__mmask16)((1u << (count - i)) - 1);
+        _mm512_mask_storeu_ps(target + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, target + i), g));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void mixAvx512(const AudioSample *const *sources, const AudioSample *gains, int numberOfSources,
+                      AudioSample *target, int count, bool accumulate) {
+    for(int i = 0; i < count; i += 16) {
+        __mmask16 mask = count - i >= 16 ? (__mmask16)0xffff : (__mmask16)((1u << (count - i)) - 1);
+        __m512 a = accumulate ? _mm512_maskz_loadu_ps(mask, target + i) : _mm512_setzero_ps();
+        for(int s = 0; s < numberOfSources; s++) {
+            a = _mm512_add_ps(a, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, sources[s] + i),
+                                               _mm512_set1_ps(gains[s])));
+        }
+        _mm512_mask_storeu_ps(target + i, mask, a);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void scaleRampAvx512(AudioSample *target, int count, AudioSample startGain, AudioSample increment) {
+    const __m512 start = _mm512_set1_ps(startGain);
+    const __m512 step = _mm512_set1_ps(increment);
+    const __m512 lanes = _mm512_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+                                        8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f);
+    for(int i = 0; i < count; i += 16) {
+        __mmask16 mask = count - i >= 16 ? (__mmask16)0xffff : (__mmask16)((1u << (count - i)) - 1);
+        __m512 g = _mm512_add_ps(start, _mm512_mul_ps(_mm512_add_ps(_mm512_set1_ps((AudioSample)i), lanes), step));
+        _mm512_mask_storeu_ps(target + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, target + i), g));
+    }
+}
+
+__attribute__((target("avx512f")))
+static void addScaledRampAvx512(const AudioSample *source, AudioSample *target, int count,
+                                AudioSample startGain, AudioSample increment) {
+    const __m512 start = _mm512_set1_ps(startGain);
+    const __m512 step = _mm512_set1_ps(increment);
+    const __m512 lanes = _mm512_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+                                        8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f);
+    for(int i = 0; i < count; i += 16) {
+        __mmask16 mask = count - i >= 16 ? (__mmask16)0xffff : (__mmask16)((1u << (count - i)) - 1);
+        __m512 g = _mm512_add_ps(start, _mm512_mul_ps(_mm512_add_ps(_mm512_set1_ps((AudioSample)i), lanes), step));
+        __m512 a = _mm512_add_ps(_mm512_maskz_loadu_ps(mask, target + i),
+                                 _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, source + i), g));
+        _mm512_mask_storeu_ps(target + i, mask, a);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void scaleExponentialRampAvx512(AudioSample *target, int count, AudioSample startGain,
+                                       const AudioSample *factors, AudioSample blockRatio) {
+    const __m512 f = _mm512_loadu_ps(factors);
+    AudioSample blockGain = startGain;
+    for(int i = 0; i < count; i += RampBlock) {
+        __mmask16 mask = count - i >= 16 ? (__mmask16)0xffff : (__mmask16)((1u << (count - i)) - 1);
+        __m512 g = _mm512_mul_ps(_mm512_set1_ps(blockGain), f);
+        _mm512_mask_storeu_ps(target + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, target + i), g));
+        blockGain *= blockRatio;
+    }
+}
+
+__attribute__((target("avx512f")))
+static void addScaledExponentialRampAvx512(const AudioSample *source, AudioSample *target, int count,
+                                           AudioSample startGain, const AudioSample *factors,
+                                           AudioSample blockRatio) {
+    const __m512 f = _mm512_loadu_ps(factors);
+    AudioSample blockGain = startGain;
+    for(int i = 0; i < count; i += RampBlock) {
+        __mmask16 mask = count - i >= 16 ? (__mmask16)0xffff : (__mmask16)((1u << (count - i)) - 1);
+        __m512 g = _mm512_mul_ps(_mm512_set1_ps(blockGain), f);
+        __m512 a = _mm512_add_ps(_mm512_maskz_loadu_ps(mask, target + i),
+                                 _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, source + i), g));
+        _mm512_mask_storeu_ps(target + i, mask, a);
+        blockGain *= blockRatio;
+    }
+}
+
+
+#elif defined(QTJACK_KERNELS_NEON)
+
+static void addNeon(const AudioSample *source, AudioSample *target, int count) {
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        float32x4_t a = vaddq_f32(vld1q_f32(target + i),     vld1q_f32(source + i));
+        float32x4_t b = vaddq_f32(vld1q_f32(target + i + 4), vld1q_f32(source + i + 4));
+        vst1q_f32(target + i,     a);
+        vst1q_f32(target + i + 4, b);
+    }
+    addScalar(source + i, target + i, count - i);
+}
+
+static void addScaledNeon(const AudioSample *source, AudioSample *target, int count, AudioSample gain) {
+    const float32x4_t g = vdupq_n_f32(gain);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        float32x4_t a = vaddq_f32(vld1q_f32(target + i),     vmulq_f32(vld1q_f32(source + i),     g));
+        float32x4_t b = vaddq_f32(vld1q_f32(target + i + 4), vmulq_f32(vld1q_f32(source + i + 4), g));
+        vst1q_f32(target + i,     a);
+        vst1q_f32(target + i + 4, b);
+    }
+    addScaledScalar(source + i, target + i, count - i, gain);
+}
+
+static void scaleNeon(AudioSample *target, int count, AudioSample gain) {
+    const float32x4_t g = vdupq_n_f32(gain);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        vst1q_f32(target + i,     vmulq_f32(vld1q_f32(target + i),     g));
+        vst1q_f32(target + i + 4, vmulq_f32(vld1q_f32(target + i + 4), g));
+    }
+    scaleScalar(target + i, count - i, gain);
+}
+
+static void mixNeon(const AudioSample *const *sources, const AudioSample *gains, int numberOfSources,
+                    AudioSample *target, int count, bool accumulate) {
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        float32x4_t a = accumulate ? vld1q_f32(target + i)     : vdupq_n_f32(0.0f);
+        float32x4_t b = accumulate ? vld1q_f32(target + i + 4) : vdupq_n_f32(0.0f);
+        for(int s = 0; s < numberOfSources; s++) {
+            const float32x4_t g = vdupq_n_f32(gains[s]);
+            a = vaddq_f32(a, vmulq_f32(vld1q_f32(sources[s] + i),     g));
+            b = vaddq_f32(b, vmulq_f32(vld1q_f32(sources[s] + i + 4), g));
+        }
+        vst1q_f32(target + i,     a);
+        vst1q_f32(target + i + 4, b);
+    }
+    mixRange(sources, gains, numberOfSources, target, i, count, accumulate);
+}
+
+static void scaleRampNeon(AudioSample *target, int count, AudioSample startGain, AudioSample increment) {
+    const float32x4_t start = vdupq_n_f32(startGain);
+    const float32x4_t step = vdupq_n_f32(increment);
+    const AudioSample laneIndices[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+    const float32x4_t lanes = vld1q_f32(laneIndices);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        float32x4_t ga = vaddq_f32(start, vmulq_f32(vaddq_f32(vdupq_n_f32((AudioSample)i),       lanes), step));
+        float32x4_t gb = vaddq_f32(start, vmulq_f32(vaddq_f32(vdupq_n_f32((AudioSample)(i + 4)), lanes), step));
+        vst1q_f32(target + i,     vmulq_f32(vld1q_f32(target + i),     ga));
+        vst1q_f32(target + i + 4, vmulq_f32(vld1q_f32(target + i + 4), gb));
+    }
+    for(; i < count; i++) {
+        target[i] *= startGain + (AudioSample)i * increment;
+    }
+}
+
+static void addScaledRampNeon(const AudioSample *source, AudioSample *target, int count,
+                              AudioSample startGain, AudioSample increment) {
+    const float32x4_t start = vdupq_n_f32(startGain);
+    const float32x4_t step = vdupq_n_f32(increment);
+    const AudioSample laneIndices[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+    const float32x4_t lanes = vld1q_f32(laneIndices);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        float32x4_t ga = vaddq_f32(start, vmulq_f32(vaddq_f32(vdupq_n_f32((AudioSample)i),       lanes), step));
+        float32x4_t gb = vaddq_f32(start, vmulq_f32(vaddq_f32(vdupq_n_f32((AudioSample)(i + 4)), lanes), step));
+        vst1q_f32(target + i,     vaddq_f32(vld1q_f32(target + i),     vmulq_f32(vld1q_f32(source + i),     ga)));
+        vst1q_f32(target + i + 4, vaddq_f32(vld1q_f32(target + i + 4), vmulq_f32(vld1q_f32(source + i + 4), gb)));
+    }
+    for(; i < count; i++) {
+        target[i] += source[i] * (startGain + (AudioSample)i * increment);
+    }
+}
+
+static void scaleExponentialRampNeon(AudioSample *target, int count, AudioSample startGain,
+                                     const AudioSample *factors, AudioSample blockRatio) {
+    const float32x4_t f0 = vld1q_f32(factors);
+    const float32x4_t f1 = vld1q_f32(factors + 4);
+    const float32x4_t f2 = vld1q_f32(factors + 8);
+    const float32x4_t f3 = vld1q_f32(factors + 12);
+    AudioSample blockGain = startGain;
+    int i = 0;
+    for(; i + RampBlock <= count; i += RampBlock) {
+        const float32x4_t g = vdupq_n_f32(blockGain);
+        vst1q_f32(target + i,      vmulq_f32(vld1q_f32(target + i),      vmulq_f32(g, f0)));
+        vst1q_f32(target + i + 4,  vmulq_f32(vld1q_f32(target + i + 4),  vmulq_f32(g, f1)));
+        vst1q_f32(target + i + 8,  vmulq_f32(vld1q_f32(target + i + 8),  vmulq_f32(g, f2)));
+        vst1q_f32(target + i + 12, vmulq_f32(vld1q_f32(target + i + 12), vmulq_f32(g, f3)));
+        blockGain *= blockRatio;
+    }
+    scaleExponentialRampScalar(target + i, count - i, blockGain, factors, blockRatio);
+}
+
+static void addScaledExponentialRampNeon(const AudioSample *source, AudioSample *target, int count,
+                                         AudioSample startGain, const AudioSample *factors,
+                                         AudioSample blockRatio) {
+    const float32x4_t f0 = vld1q_f32(factors);
+    const float32x4_t f1 = vld1q_f32(factors + 4);
+    const float32x4_t f2 = vld1q_f32(factors + 8);
+    const float32x4_t f3 = vld1q_f32(factors + 12);
+    AudioSample blockGain = startGain;
+    int i = 0;
+    for(; i + RampBlock <= count; i += RampBlock) {
+        const float32x4_t g = vdupq_n_f32(blockGain);
+        vst1q_f32(target + i,      vaddq_f32(vld1q_f32(target + i),      vmulq_f32(vld1q_f32(source + i),      vmulq_f32(g, f0))));
+        vst1q_f32(target + i + 4,  vaddq_f32(vld1q_f32(target + i + 4),  vmulq_f32(vld1q_f32(source + i + 4),  vmulq_f32(g, f1))));
+        vst1q_f32(target + i + 8,  vaddq_f32(vld1q_f32(target + i + 8),  vmulq_f32(vld1q_f32(source + i + 8),  vmulq_f32(g, f2))));
+        vst1q_f32(target + i + 12, vaddq_f32(vld1q_f32(target + i + 12), vmulq_f32(vld1q_f32(source + i + 12), vmulq_f32(g, f3))));
+        blockGain *= blockRatio;
+    }
+    addScaledExponentialRampScalar(source + i, target + i, count - i, blockGain, factors, blockRatio);
+}
+
+#if defined(__aarch64__)
+static void toIntegerNeon(const AudioSample *source, int32_t *target, int count, AudioSample scale,
+                          AudioSample minimum, AudioSample maximum, const AudioSample *dither) {
+    const float32x4_t s = vdupq_n_f32(scale);
+    const float32x4_t lower = vdupq_n_f32(minimum);
+    const float32x4_t upper = vdupq_n_f32(maximum);
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        float32x4_t value = vmulq_f32(vld1q_f32(source + i), s);
+        if(dither) {
+            value = vaddq_f32(value, vld1q_f32(dither + i));
+        }
+        value = vminq_f32(vmaxq_f32(value, lower), upper);
+        vst1q_s32(target + i, vcvtnq_s32_f32(value));
+    }
+    toIntegerScalar(source + i, target + i, count - i, scale, minimum, maximum, dither ? dither + i : 0);
+}
+#else
+// 32 bit NEON has no conversion rounding to nearest.
+#define toIntegerNeon toIntegerScalar
+#endif
+
+static void fromIntegerNeon(const int32_t *source, AudioSample *target, int count, AudioSample scale) {
+    const float32x4_t s = vdupq_n_f32(scale);
+    int i = 0;
+    for(; i + 4 <= count; i += 4) {
+        vst1q_f32(target + i, vmulq_f32(vcvtq_f32_s32(vld1q_s32(source + i)), s));
+    }
+    fromIntegerScalar(source + i, target + i, count - i, scale);
+}
+
+static int measureNeon(const AudioSample *source, int count, AudioSample clipLevel,
+                       AudioSample *peak, AudioSample *partials) {
+    const float32x4_t clip = vdupq_n_f32(clipLevel);
+    float32x4_t sums[4];
+    for(int k = 0; k < 4; k++) {
+        sums[k] = vld1q_f32(partials + 4 * k);
+    }
+    float32x4_t maximum = vdupq_n_f32(*peak);
+    uint32x4_t clips = vdupq_n_u32(0);
+    int i = 0;
+    for(; i + MeasureLanes <= count; i += MeasureLanes) {
+        for(int k = 0; k < 4; k++) {
+            float32x4_t value = vld1q_f32(source + i + 4 * k);
+            float32x4_t magnitude = vabsq_f32(value);
+            maximum = vbslq_f32(vcgtq_f32(magnitude, maximum), magnitude, maximum);
+            sums[k] = vaddq_f32(sums[k], vmulq_f32(value, value));
+            clips = vsubq_u32(clips, vcgeq_f32(magnitude, clip));
+        }
+    }
+    AudioSample maxima[4];
+    uint32_t counts[4];
+    vst1q_f32(maxima, maximum);
+    vst1q_u32(counts, clips);
+    for(int k = 0; k < 4; k++) {
+        vst1q_f32(partials + 4 * k, sums[k]);
+        *peak = maxima[k] > *peak ? maxima[k] : *peak;
+    }
+    return (int)(counts[0] + counts[1] + counts[2] + counts[3])
+         + measureScalar(source + i, count - i, clipLevel, peak, partials);
+}
+
+#endif
+
+/** Dispatch table, filled in once at load time. */
+struct KernelTable {
+    const char *instructionSet;
+    void (*add)(const AudioSample*, AudioSample*, int);
+    void (*addScaled)(const AudioSample*, AudioSample*, int, AudioSample);
+    void (*scale)(AudioSample*, int, AudioSample);
+    void (*mix)(const AudioSample *const*, const AudioSample*, int, AudioSample*, int, bool);
+    void (*scaleRamp)(AudioSample*, int, AudioSample, AudioSample);
+    void (*addScaledRamp)(const AudioSample*, AudioSample*, int, AudioSample, AudioSample);
+    void (*scaleExponentialRamp)(AudioSample*, int, AudioSample, const AudioSample*, AudioSample);
+    void (*addScaledExponentialRamp)(const AudioSample*, AudioSample*, int, AudioSample, const AudioSample*, AudioSample);
+    void (*toInteger)(const AudioSample*, int32_t*, int, AudioSample, AudioSample, AudioSample, const AudioSample*);
+    void (*fromInteger)(const int32_t*, AudioSample*, int, AudioSample);
+    int (*measure)(const AudioSample*, int, AudioSample, AudioSample*, AudioSample*);
+};
+
+// Constant initialized, so the scalar kernels are in place even if another
+// static initializer happens to run before the selection below.
+static KernelTable kernels = {
+    "scalar",
+    addScalar,
+    addScaledScalar,
+    scaleScalar,
+    mixScalar,
+    scaleRampScalar,
+    addScaledRampScalar,
+    scaleExponentialRampScalar,
+    addScaledExponentialRampScalar,
+    toIntegerScalar,
+    fromIntegerScalar,
+    measureScalar
+};
+
+class KernelSelector {
+public:
+    KernelSelector() {
+#if defined(QTJACK_KERNELS_X86)
+        // Required when querying CPU features from a static initializer.
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f")) {
+            kernels = { "avx512", addAvx512, addScaledAvx512, scaleAvx512, mixAvx512,
+                        scaleRampAvx512, addScaledRampAvx512,
+                        scaleExponentialRampAvx512, addScaledExponentialRampAvx512,
+                        toIntegerAvx2, fromIntegerAvx2,
+                        measureAvx2 };
+        } else if(__builtin_cpu_supports("avx2")) {
+            kernels = { "avx2", addAvx2, addScaledAvx2, scaleAvx2, mixAvx2,
+                        scaleRampAvx2, addScaledRampAvx2,
+                        scaleExponentialRampAvx2, addScaledExponentialRampAvx2,
+                        toIntegerAvx2, fromIntegerAvx2,
+                        measureAvx2 };
+        } else if(__builtin_cpu_supports("sse2")) {
+            kernels = { "sse2", addSse2, addScaledSse2, scaleSse2, mixSse2,
+                        scaleRampSse2, addScaledRampSse2,
+                        scaleExponentialRampSse2, addScaledExponentialRampSse2,
+                        toIntegerSse2, fromIntegerSse2,
+                        measureSse2 };
+        }
+#elif defined(QTJACK_KERNELS_NEON)
+        kernels = { "neon", addNeon, addScaledNeon, scaleNeon, mixNeon,
+                    scaleRampNeon, addScaledRampNeon,
+                    scaleExponentialRampNeon, addScaledExponentialRampNeon,
+                    toIntegerNeon, fromIntegerNeon,
+                    measureNeon };
+#endif
+    }
+};
+
+static KernelSelector kernelSelector;
+
+const char *instructionSet() {
+    return kernels.instructionSet;
+}
+
+void clear(AudioSample *target, int count) {
+    // The C library already provides the fastest variant for this CPU.
+    if(count > 0) {
+        memset(target, 0, count * sizeof(AudioSample));
+    }
+}
+
+void copy(const AudioSample *source, AudioSample *target, int count) {
+    if(count > 0 && source != target) {
+        memcpy(target, source, count * sizeof(AudioSample));
+    }
+}
+
+void add(const AudioSample *source, AudioSample *target, int count) {
+    kernels.add(source, target, count);
+}
+
+void addScaled(const AudioSample *source, AudioSample *target, int count, AudioSample gain) {
+    kernels.addScaled(source, target, count, gain);
+}
+
+void scale(AudioSample *target, int count, AudioSample gain) {
+    kernels.scale(target, count, gain);
+}
+
+void mix(const AudioSample *const *sources, const AudioSample *gains, int numberOfSources,
+         AudioSample *target, int count, bool accumulate) {
+    kernels.mix(sources, gains, numberOfSources, target, count, accumulate);
+}
+
+void scaleRamp(AudioSample *target, int count, AudioSample startGain, AudioSample increment) {
+    kernels.scaleRamp(target, count, startGain, increment);
+}
+
+void addScaledRamp(const AudioSample *source, AudioSample *target, int count,
+                   AudioSample startGain, AudioSample increment) {
+    kernels.addScaledRamp(source, target, count, startGain, increment);
+}
+
+/** Per-sample factors of a block of an exponential ramp. */
+static AudioSample exponentialRampFactors(AudioSample ratio, AudioSample *factors) {
+    factors[0] = 1.0f;
+    for(int j = 1; j < RampBlock; j++) {
+        factors[j] = factors[j - 1] * ratio;
+    }
+    return factors[RampBlock - 1] * ratio;
+}
+
+void scaleExponentialRamp(AudioSample *target, int count, AudioSample startGain, AudioSample ratio) {
+    AudioSample factors[RampBlock];
+    AudioSample blockRatio = exponentialRampFactors(ratio, factors);
+    kernels.scaleExponentialRamp(target, count, startGain, factors, blockRatio);
+}
+
+void addScaledExponentialRamp(const AudioSample *source, AudioSample *target, int count,
+                              AudioSample startGain, AudioSample ratio) {
+    AudioSample factors[RampBlock];
+    AudioSample blockRatio = exponentialRampFactors(ratio, factors);
+    kernels.addScaledExponentialRamp(source, target, count, startGain, factors, blockRatio);
+}
+
+void toInteger(const AudioSample *source, int32_t *target, int count, AudioSample scale,
+               AudioSample minimum, AudioSample maximum, const AudioSample *dither) {
+    kernels.toInteger(source, target, count, scale, minimum, maximum, dither);
+}
+
+void fromInteger(const int32_t *source, AudioSample *target, int count, AudioSample scale) {
+    kernels.fromInteger(source, target, count, scale);
+}
+
+int measure(const AudioSample *source, int count, AudioSample clipLevel,
+            AudioSample *peak, AudioSample *sumOfSquares) {
+    AudioSample partials[MeasureLanes] = { };
+    int clips = kernels.measure(source, count, clipLevel, peak, partials);
+    for(int width = MeasureLanes / 2; width > 0; width /= 2) {
+        for(int j = 0; j < width; j++) {
+            partials[j] += partials[j + width];
+        }
+    }
+    *sumOfSquares += partials[0];
+    return clips;
+}
+
+} // namespace AudioKernels
+} // namespace QtJack
@@ -50,7 +50,7 @@ AudioBuffer AudioPort::buffer(int samples) const {
     if(isValid()) {
         return AudioBuffer(samples, jack_port_get_buffer(_jackPort, samples));
     }
-    return AudioBuffer(samples, 0);
+    return AudioBuffer(samples, (void*)0);
 }
 
 } // namespace QtJack
@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "audioportgroup.h"
+
+namespace QtJack {
+
+AudioPortGroup::AudioPortGroup() {
+}
+
+AudioPortGroup::AudioPortGroup(const AudioPortGroup& other) {
+    _p = other._p;
+}
+
+AudioPortGroup::AudioPortGroup(QVector<AudioPort> ports) {
+    _p = QSharedPointer<AudioPortGroupPrivate>(new AudioPortGroupPrivate());
+    _p->_ports = ports;
+    _p->_samples = 0;
+    for(int i = 0; i < ports.size(); i++) {
+        _p->_jackPorts.append(ports[i]._jackPort);
+    }
+    _p->_channels.fill(0, ports.size());
+}
+
+AudioPortGroup::~AudioPortGroup() {
+}
+
+int AudioPortGroup::numberOfChannels() const {
+    return _p ? _p->_channels.size() : 0;
+}
+
+AudioPort AudioPortGroup::port(int channel) const {
+    if(channel < 0 || channel >= numberOfChannels()) {
+        return AudioPort();
+    }
+    return _p->_ports.at(channel);
+}
+
+QList<AudioPort> AudioPortGroup::ports() const {
+    if(!_p) {
+        return QList<AudioPort>();
+    }
+    return _p->_ports.toList();
+}
+
+void AudioPortGroup::resolveBuffers(int samples) {
+    if(!_p) {
+        return;
+    }
+
+    jack_port_t **jackPorts = _p->_jackPorts.data();
+    AudioSample **channels = _p->_channels.data();
+    int numberOfChannels = _p->_channels.size();
+    for(int i = 0; i < numberOfChannels; i++) {
+        channels[i] = (AudioSample*)jack_port_get_buffer(jackPorts[i], samples);
+    }
+    _p->_samples = samples;
+}
+
+int AudioPortGroup::samples() const {
+    return _p ? _p->_samples : 0;
+}
+
+AudioSample * const *AudioPortGroup::channels() const {
+    return _p ? _p->_channels.constData() : 0;
+}
+
+AudioSample *AudioPortGroup::channel(int channel) const {
+    if(channel < 0 || channel >= numberOfChannels()) {
+        return 0;
+    }
+    return _p->_channels.at(channel);
+}
+
+AudioBuffer AudioPortGroup::buffer(int channel) const {
+    return AudioBuffer(samples(), (void*)this->channel(channel));
+}
+
+} // namespace QtJack
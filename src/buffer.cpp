@@ -23,6 +23,7 @@
 
 // Own includes
 #include "buffer.h"
+#include "bufferpool.h"
 
 // JACK includes
 #include <jack/jack.h>
@@ -32,19 +33,79 @@ namespace QtJack {
 Buffer::Buffer() {
     _size = 1024;
     _jackBuffer = 0;
+    _memory = 0;
 }
 
 Buffer::Buffer(const Buffer& other) {
     _size = other._size;
     _jackBuffer = other._jackBuffer;
+    _memory = other._memory;
+    if(_memory) {
+        _memory->_references.fetch_add(1, std::memory_order_relaxed);
+    }
 }
 
 Buffer::Buffer(int bufferSize, void *buffer) {
     _size = bufferSize;
     _jackBuffer = buffer;
+    _memory = 0;
+}
+
+Buffer::Buffer(int bufferSize, BufferMemory *memory) {
+    _size = bufferSize;
+    _jackBuffer = memory ? memory->_data : 0;
+    _memory = memory;
 }
 
 Buffer::~Buffer() {
+    releaseMemory();
+}
+
+Buffer& Buffer::operator=(const Buffer& other) {
+    if(other._memory) {
+        other._memory->_references.fetch_add(1, std::memory_order_relaxed);
+    }
+    releaseMemory();
+
+    _size = other._size;
+    _jackBuffer = other._jackBuffer;
+    _memory = other._memory;
+    return *this;
+}
+
+void Buffer::releaseMemory() {
+    if(!_memory) {
+        return;
+    }
+
+    // Pooled memory becomes available again as soon as the last reference
+    // is gone, standalone memory has to be freed.
+    if(_memory->_references.fetch_sub(1, std::memory_order_acq_rel) == 1
+    && !_memory->_pool) {
+        BufferPool::freeMemory(_memory);
+    }
+    _memory = 0;
+}
+
+AudioBuffer Buffer::createMemoryAudioBuffer(int size) {
+    BufferMemory *memory = BufferPool::allocateMemory(size * sizeof(AudioSample));
+    if(!memory) {
+        return AudioBuffer();
+    }
+    return AudioBuffer(size, memory);
+}
+
+MidiBuffer Buffer::createMemoryMidiBuffer(int size) {
+    // jack_midi_reset_buffer() assumes the size of a MIDI port buffer.
+    if(size < BufferPool::minimumMidiBufferSize()) {
+        size = BufferPool::minimumMidiBufferSize();
+    }
+    BufferMemory *memory = BufferPool::allocateMemory(size);
+    if(!memory) {
+        return MidiBuffer();
+    }
+    jack_midi_reset_buffer(memory->_data);
+    return MidiBuffer(size, memory);
 }
 
 int Buffer::size() const {
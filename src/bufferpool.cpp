@@ -0,0 +1,219 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "bufferpool.h"
+#include "client.h"
+
+// Standard includes
+#include <cstdlib>
+#include <cstring>
+
+// System includes
+#include <sys/mman.h>
+
+namespace QtJack {
+
+static std::atomic<int> minimumMidiBytes(BufferPool::DefaultMinimumMidiBufferSize);
+
+static size_t alignedSize(size_t bytes) {
+    return (bytes + BufferPool::Alignment - 1) & ~(size_t)(BufferPool::Alignment - 1);
+}
+
+BufferPool::BufferPool(int audioBufferSize,
+                       int numberOfAudioBuffers,
+                       int midiBufferSize,
+                       int numberOfMidiBuffers) {
+    _audioBufferSize = audioBufferSize;
+    _midiBufferSize = midiBufferSize;
+    initialize(numberOfAudioBuffers, numberOfMidiBuffers);
+}
+
+BufferPool::BufferPool(const Client& client,
+                       int numberOfAudioBuffers,
+                       int numberOfMidiBuffers) {
+    _audioBufferSize = client.bufferSize();
+    _midiBufferSize = client.midiBufferSize();
+    initialize(numberOfAudioBuffers, numberOfMidiBuffers);
+}
+
+BufferPool::~BufferPool() {
+    if(_memory) {
+        if(_locked) {
+            munlock(_memory, _memorySize);
+        }
+        free(_memory);
+    }
+    delete[] _audioBlocks;
+    delete[] _midiBlocks;
+}
+
+void BufferPool::initialize(int numberOfAudioBuffers, int numberOfMidiBuffers) {
+    if(_audioBufferSize <= 0) {
+        numberOfAudioBuffers = 0;
+    }
+    if(_midiBufferSize <= 0) {
+        numberOfMidiBuffers = 0;
+    } else if(_midiBufferSize < minimumMidiBufferSize()) {
+        // jack_midi_reset_buffer() assumes the size of a MIDI port buffer.
+        _midiBufferSize = minimumMidiBufferSize();
+    }
+    _numberOfAudioBlocks = numberOfAudioBuffers > 0 ? numberOfAudioBuffers : 0;
+    _numberOfMidiBlocks = numberOfMidiBuffers > 0 ? numberOfMidiBuffers : 0;
+
+    size_t audioBlockSize = alignedSize(_audioBufferSize * sizeof(AudioSample));
+    size_t midiBlockSize = alignedSize(_midiBufferSize);
+    _memorySize = audioBlockSize * _numberOfAudioBlocks
+                + midiBlockSize * _numberOfMidiBlocks;
+
+    _memory = 0;
+    _locked = false;
+    if(_memorySize > 0 && posix_memalign(&_memory, Alignment, _memorySize) == 0) {
+        // Touch all pages, so that no page faults occur on the process thread.
+        memset(_memory, 0, _memorySize);
+        _locked = (mlock(_memory, _memorySize) == 0);
+    } else {
+        _memory = 0;
+        _numberOfAudioBlocks = 0;
+        _numberOfMidiBlocks = 0;
+    }
+
+    char *data = (char*)_memory;
+    _audioBlocks = new BufferMemory[_numberOfAudioBlocks];
+    for(int i = 0; i < _numberOfAudioBlocks; i++) {
+        _audioBlocks[i]._references.store(0, std::memory_order_relaxed);
+        _audioBlocks[i]._pool = this;
+        _audioBlocks[i]._data = data;
+        _audioBlocks[i]._bytes = (int)audioBlockSize;
+        _audioBlocks[i]._locked = _locked;
+        data += audioBlockSize;
+    }
+
+    _midiBlocks = new BufferMemory[_numberOfMidiBlocks];
+    for(int i = 0; i < _numberOfMidiBlocks; i++) {
+        _midiBlocks[i]._references.store(0, std::memory_order_relaxed);
+        _midiBlocks[i]._pool = this;
+        _midiBlocks[i]._data = data;
+        _midiBlocks[i]._bytes = (int)midiBlockSize;
+        _midiBlocks[i]._locked = _locked;
+        jack_midi_reset_buffer(data);
+        data += midiBlockSize;
+    }
+}
+
+int BufferPool::minimumMidiBufferSize() {
+    return minimumMidiBytes.load(std::memory_order_relaxed);
+}
+
+void BufferPool::setMinimumMidiBufferSize(int bytes) {
+    if(bytes > 0) {
+        minimumMidiBytes.store(bytes, std::memory_order_relaxed);
+    }
+}
+
+bool BufferPool::isMemoryLocked() const {
+    return _locked;
+}
+
+AudioBuffer BufferPool::acquireAudioBuffer() {
+    BufferMemory *memory = acquire(_audioBlocks, _numberOfAudioBlocks);
+    if(!memory) {
+        return AudioBuffer();
+    }
+    return AudioBuffer(_audioBufferSize, memory);
+}
+
+MidiBuffer BufferPool::acquireMidiBuffer() {
+    BufferMemory *memory = acquire(_midiBlocks, _numberOfMidiBlocks);
+    if(!memory) {
+        return MidiBuffer();
+    }
+    return MidiBuffer(_midiBufferSize, memory);
+}
+
+int BufferPool::numberOfAvailableAudioBuffers() const {
+    return numberOfAvailable(_audioBlocks, _numberOfAudioBlocks);
+}
+
+int BufferPool::numberOfAvailableMidiBuffers() const {
+    return numberOfAvailable(_midiBlocks, _numberOfMidiBlocks);
+}
+
+BufferMemory *BufferPool::acquire(BufferMemory *blocks, int numberOfBlocks) {
+    // A block is free when no handle refers to it. Claiming it is a single
+    // compare-and-swap, so acquiring is lock-free from any thread.
+    for(int i = 0; i < numberOfBlocks; i++) {
+        int expected = 0;
+        if(blocks[i]._references.load(std::memory_order_relaxed) == 0
+        && blocks[i]._references.compare_exchange_strong(expected, 1, std::memory_order_acquire)) {
+            return &blocks[i];
+        }
+    }
+    return 0;
+}
+
+int BufferPool::numberOfAvailable(const BufferMemory *blocks, int numberOfBlocks) {
+    int available = 0;
+    for(int i = 0; i < numberOfBlocks; i++) {
+        if(blocks[i]._references.load(std::memory_order_relaxed) == 0) {
+            available++;
+        }
+    }
+    return available;
+}
+
+BufferMemory *BufferPool::allocateMemory(int bytes) {
+    if(bytes <= 0) {
+        return 0;
+    }
+
+    size_t size = alignedSize(bytes);
+    void *data = 0;
+    if(posix_memalign(&data, Alignment, size) != 0) {
+        return 0;
+    }
+    memset(data, 0, size);
+
+    BufferMemory *memory = new BufferMemory;
+    memory->_references.store(1, std::memory_order_relaxed);
+    memory->_pool = 0;
+    memory->_data = data;
+    memory->_bytes = (int)size;
+    memory->_locked = (mlock(data, size) == 0);
+    return memory;
+}
+
+void BufferPool::freeMemory(BufferMemory *memory) {
+    if(!memory) {
+        return;
+    }
+
+    if(memory->_locked) {
+        munlock(memory->_data, memory->_bytes);
+    }
+    free(memory->_data);
+    delete memory;
+}
+
+} // namespace QtJack
@@ -24,6 +24,7 @@
 // Own includes:
 #include "processor.h"
 #include "client.h"
+#include "bufferpool.h"
 
 // Standard includes
 #include <cstdlib>
@@ -38,6 +39,7 @@ Client::Client(QObject *parent) :
     QObject(parent),
     _processor(0) {
     _jackClient = 0;
+    _appliedRealtimeSteps = RealtimePolicy::StepNone;
 }
 
 Client::~Client() {
@@ -69,6 +71,8 @@ bool Client::connectToServer(QString name) {
         jack_on_shutdown(_jackClient, Client::shutdownCallback, (void*)this);
         jack_on_info_shutdown(_jackClient, Client::infoShutdownCallback, (void*)this);
 
+        BufferPool::setMinimumMidiBufferSize(midiBufferSize());
+
         Q_EMIT connectedToServer();
         return true;
     }
@@ -114,6 +118,38 @@ AudioPort Client::registerAudioInPort(QString name) {
     return audioPort;
 }
 
+AudioPortGroup Client::registerAudioOutPorts(QString name, int numberOfPorts) {
+    return registerAudioPorts(name, numberOfPorts, JackPortIsOutput);
+}
+
+AudioPortGroup Client::registerAudioInPorts(QString name, int numberOfPorts) {
+    return registerAudioPorts(name, numberOfPorts, JackPortIsInput);
+}
+
+AudioPortGroup Client::registerAudioPorts(QString name, int numberOfPorts, JackPortFlags jackPortFlags) {
+    if(!_jackClient || numberOfPorts <= 0) {
+        return AudioPortGroup();
+    }
+
+    QVector<AudioPort> ports;
+    for(int i = 0; i < numberOfPorts; i++) {
+        jack_port_t *jackPort = jack_port_register(_jackClient,
+                                                   QString("%1_%2").arg(name).arg(i + 1).toStdString().c_str(),
+                                                   JACK_DEFAULT_AUDIO_TYPE,
+                                                   jackPortFlags, 0);
+        if(!jackPort) {
+            // Do not leave a partial group behind.
+            Q_FOREACH(AudioPort port, ports) {
+                jack_port_unregister(_jackClient, port._jackPort);
+            }
+            return AudioPortGroup();
+        }
+        ports.append(AudioPort(jackPort));
+    }
+
+    return AudioPortGroup(ports);
+}
+
 MidiPort Client::registerMidiOutPort(QString name) {
     if(!_jackClient) {
         return MidiPort();
@@ -280,6 +316,13 @@ int Client::bufferSize() const {
     return jack_get_buffer_size(_jackClient);
 }
 
+int Client::midiBufferSize() const {
+    if(!_jackClient) {
+        return -1;
+    }
+    return (int)jack_port_type_get_buffer_size(_jackClient, JACK_DEFAULT_MIDI_TYPE);
+}
+
 float Client::cpuLoad() const {
     if(!_jackClient) {
         return 0.0;
@@ -372,11 +415,27 @@ void Client::setMainProcessor(Processor *audioProcessor) {
     _processor = audioProcessor;
 }
 
+void Client::setRealtimePolicy(RealtimePolicy realtimePolicy) {
+    _realtimePolicy = realtimePolicy;
+}
+
+RealtimePolicy Client::realtimePolicy() const {
+    return _realtimePolicy;
+}
+
+int Client::appliedRealtimeSteps() const {
+    return _appliedRealtimeSteps.load();
+}
+
 void Client::threadInit() {
+    int appliedSteps = _realtimePolicy.apply();
+    _appliedRealtimeSteps.store(appliedSteps);
+    Q_EMIT realtimePolicyApplied(_realtimePolicy.requestedSteps(), appliedSteps);
 }
 
 void Client::process(int samples) {
     if(_processor) {
+        _processor->dispatchCommands(_processor->commandBudget());
         _processor->process(samples);
     }
 }
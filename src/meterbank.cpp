@@ -0,0 +1,151 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "meterbank.h"
+#include "audiokernels.h"
+
+// Standard includes
+#include <cmath>
+
+namespace QtJack {
+
+MeterBank::MeterBank(int numberOfMeters, QObject *parent)
+    : QObject(parent),
+      _published(std::vector<MeterLevel>(numberOfMeters > 0 ? numberOfMeters : 0)) {
+    _numberOfMeters = numberOfMeters > 0 ? numberOfMeters : 0;
+    _clipLevel = 1.0f;
+
+    _cycle = new Accumulator[_numberOfMeters];
+    _pending = new Accumulator[_numberOfMeters];
+    for(int i = 0; i < _numberOfMeters; i++) {
+        _cycle[i] = Accumulator();
+        _pending[i] = Accumulator();
+    }
+
+    _levels.resize(_numberOfMeters);
+
+    connect(&_timer, &QTimer::timeout, this, &MeterBank::poll);
+}
+
+MeterBank::~MeterBank() {
+    delete[] _cycle;
+    delete[] _pending;
+}
+
+AudioSample MeterBank::clipLevel() const {
+    return _clipLevel.load(std::memory_order_relaxed);
+}
+
+void MeterBank::setClipLevel(AudioSample clipLevel) {
+    _clipLevel.store(clipLevel, std::memory_order_relaxed);
+}
+
+void MeterBank::measure(int meter, const AudioSample *samples, int count) {
+    if(meter < 0 || meter >= _numberOfMeters || count <= 0) {
+        return;
+    }
+
+    Accumulator& accumulator = _cycle[meter];
+    AudioSample sumOfSquares = 0.0f;
+    accumulator._clips += AudioKernels::measure(samples, count, clipLevel(),
+                                                &accumulator._peak, &sumOfSquares);
+    accumulator._sumOfSquares += sumOfSquares;
+    accumulator._frames += count;
+}
+
+void MeterBank::measure(int meter, const AudioBuffer& buffer) {
+    if(!buffer.isValid()) {
+        return;
+    }
+    measure(meter, (const AudioSample*)buffer.internalMemory(), buffer.size());
+}
+
+void MeterBank::measure(int firstMeter, const AudioPortGroup& portGroup) {
+    int numberOfChannels = portGroup.numberOfChannels();
+    for(int channel = 0; channel < numberOfChannels; channel++) {
+        measure(firstMeter + channel, portGroup.channel(channel), portGroup.samples());
+    }
+}
+
+void MeterBank::publish() {
+    // Start over once the Qt side has taken the previous levels, otherwise
+    // keep accumulating. If the Qt side takes them while this runs, a peak
+    // may be reported twice, but is never lost.
+    bool taken = !_published.hasUpdate();
+
+    std::vector<MeterLevel>& levels = _published.writeBuffer();
+    for(int i = 0; i < _numberOfMeters; i++) {
+        if(taken) {
+            _pending[i] = _cycle[i];
+        } else {
+            merge(_pending[i], _cycle[i]);
+        }
+        _cycle[i] = Accumulator();
+
+        const Accumulator& accumulator = _pending[i];
+        levels[i]._peak = accumulator._peak;
+        levels[i]._rms = accumulator._frames > 0
+            ? (AudioSample)std::sqrt(accumulator._sumOfSquares / accumulator._frames)
+            : 0.0f;
+        levels[i]._clips = accumulator._clips;
+    }
+
+    _published.publish();
+}
+
+MeterLevel MeterBank::level(int meter) const {
+    return _levels.value(meter);
+}
+
+void MeterBank::startPolling(int milliseconds) {
+    _timer.start(milliseconds);
+}
+
+void MeterBank::stopPolling() {
+    _timer.stop();
+}
+
+bool MeterBank::poll() {
+    if(!_published.update()) {
+        return false;
+    }
+
+    const std::vector<MeterLevel>& levels = _published.readBuffer();
+    for(int i = 0; i < _numberOfMeters; i++) {
+        _levels[i] = levels[i];
+    }
+
+    Q_EMIT levelsChanged();
+    return true;
+}
+
+void MeterBank::merge(Accumulator& target, const Accumulator& source) {
+    target._peak = source._peak > target._peak ? source._peak : target._peak;
+    target._sumOfSquares += source._sumOfSquares;
+    target._clips += source._clips;
+    target._frames += source._frames;
+}
+
+} // namespace QtJack
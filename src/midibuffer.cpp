@@ -38,6 +38,10 @@ MidiBuffer::MidiBuffer(int size, void *buffer)
     : Buffer(size, buffer) {
 }
 
+MidiBuffer::MidiBuffer(int size, BufferMemory *memory)
+    : Buffer(size, memory) {
+}
+
 MidiBuffer::~MidiBuffer() {
 }
 
@@ -90,6 +94,36 @@ MidiEvent MidiBuffer::readEvent(int index, bool *ok) {
     return midiEvent;
 }
 
+MidiBuffer::const_iterator MidiBuffer::begin() const {
+    return const_iterator(_jackBuffer, 0);
+}
+
+MidiBuffer::const_iterator MidiBuffer::end() const {
+    if(!isValid()) {
+        return const_iterator(_jackBuffer, 0);
+    }
+    return const_iterator(_jackBuffer, (int)jack_midi_get_event_count(_jackBuffer));
+}
+
+int MidiBuffer::readEvents(MidiEventView *events, int maximumNumberOfEvents, int firstIndex) const {
+    if(!isValid() || firstIndex < 0) {
+        return 0;
+    }
+
+    int numberOfEvents = (int)jack_midi_get_event_count(_jackBuffer) - firstIndex;
+    if(numberOfEvents > maximumNumberOfEvents) {
+        numberOfEvents = maximumNumberOfEvents;
+    }
+
+    int count = 0;
+    for(int i = 0; i < numberOfEvents; i++) {
+        if(jack_midi_event_get(&events[count]._event, _jackBuffer, firstIndex + i) == 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
 bool MidiBuffer::write(int i, MidiData value) {
     if(!isValid()) {
         return false;
@@ -161,19 +195,56 @@ bool MidiBuffer::copyTo(MidiBuffer targetBuffer) const {
 }
 
 bool MidiBuffer::push(MidiRingBuffer &ringBuffer) {
-    if(_size <= ringBuffer.numberOfElementsCanBeWritten()) {
-        ringBuffer.write((MidiData*)_jackBuffer, _size);
-        return true;
-    }
-    return false;
+    return ringBuffer.writeAll((MidiData*)_jackBuffer, _size);
 }
 
 bool MidiBuffer::pop(MidiRingBuffer &ringBuffer) {
-    if(ringBuffer.numberOfElementsAvailableForRead() >= _size) {
-        ringBuffer.read((MidiData*)_jackBuffer, _size);
-        return true;
+    return ringBuffer.readAll((MidiData*)_jackBuffer, _size);
+}
+
+bool MidiBuffer::push(MidiRecordRingBuffer &ringBuffer, quint32 frameTime) const {
+    if(!isValid()) {
+        return false;
+    }
+
+    bool success = true;
+    for(MidiEventView event : *this) {
+        success &= ringBuffer.write(frameTime + event.time(), event.data(), event.size());
+    }
+    return success;
+}
+
+bool MidiBuffer::pop(MidiRecordRingBuffer &ringBuffer, quint32 frameTime, int frames) {
+    if(!isValid()) {
+        return false;
+    }
+
+    bool success = true;
+    int lastSample = 0;
+    quint32 time;
+    int size;
+    while(ringBuffer.peek(time, size)) {
+        // Compare as signed difference, so that the comparison survives
+        // the wraparound of the frame time.
+        int sample = (int)(qint32)(time - frameTime);
+        if(sample >= frames) {
+            break;
+        }
+        // JACK requires events in ascending order.
+        if(sample < lastSample) {
+            sample = lastSample;
+        }
+
+        MidiData *data = jack_midi_event_reserve(_jackBuffer, (jack_nframes_t)sample, size);
+        if(data) {
+            ringBuffer.read(time, data, size, size);
+            lastSample = sample;
+        } else {
+            ringBuffer.skip();
+            success = false;
+        }
     }
-    return false;
+    return success;
 }
 
 int MidiBuffer::lostEventCount() {
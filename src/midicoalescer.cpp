@@ -0,0 +1,166 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "midicoalescer.h"
+
+// Standard includes
+#include <algorithm>
+
+namespace QtJack {
+
+MidiCoalescer::MidiCoalescer(int window, int maximumNumberOfEvents)
+    : _stamps(NumberOfSlots, 0),
+      _keep(maximumNumberOfEvents > 0 ? maximumNumberOfEvents : 1, 1) {
+    _window = window > 0 ? window : 0;
+    _coalescedEvents = 0;
+    _generation = 1;
+
+    // Bank select, data entry, (N)RPN and channel mode messages depend on
+    // their neighbours, and switches like sustain (64 to 69) on their
+    // position between notes, so they are kept.
+    _coalescedControllers[0] = ~0ull;
+    _coalescedControllers[1] = ~0ull;
+    static const int sequentialControllers[] = {
+        0, 6, 32, 38, 64, 65, 66, 67, 68, 69, 96, 97, 98, 99, 100, 101
+    };
+    for(int controller : sequentialControllers) {
+        setControllerCoalesced(controller, false);
+    }
+    for(int controller = 120; controller < 128; controller++) {
+        setControllerCoalesced(controller, false);
+    }
+}
+
+int MidiCoalescer::window() const {
+    return _window.load(std::memory_order_relaxed);
+}
+
+void MidiCoalescer::setWindow(int window) {
+    _window.store(window > 0 ? window : 0, std::memory_order_relaxed);
+}
+
+bool MidiCoalescer::isControllerCoalesced(int controller) const {
+    if(controller < 0 || controller > 127) {
+        return false;
+    }
+    return (_coalescedControllers[controller >> 6].load(std::memory_order_relaxed) >> (controller & 63)) & 1;
+}
+
+void MidiCoalescer::setControllerCoalesced(int controller, bool coalesced) {
+    if(controller < 0 || controller > 127) {
+        return;
+    }
+    quint64 bit = 1ull << (controller & 63);
+    if(coalesced) {
+        _coalescedControllers[controller >> 6].fetch_or(bit, std::memory_order_relaxed);
+    } else {
+        _coalescedControllers[controller >> 6].fetch_and(~bit, std::memory_order_relaxed);
+    }
+}
+
+int MidiCoalescer::process(const MidiBuffer& source, MidiBuffer& target) {
+    target.clearEventBuffer();
+    void *jackBuffer = source.internalMemory();
+    if(!jackBuffer || !target.isValid()) {
+        return 0;
+    }
+
+    int numberOfEvents = (int)jack_midi_get_event_count(jackBuffer);
+    int numberOfTrackedEvents = qMin(numberOfEvents, (int)_keep.size());
+    int window = _window.load(std::memory_order_relaxed);
+
+    // Walk backwards, so the first message seen per slot and window is the
+    // one to keep.
+    quint32 lastWindow = 0;
+    jack_midi_event_t event;
+    for(int i = numberOfTrackedEvents - 1; i >= 0; i--) {
+        _keep[i] = 1;
+        if(jack_midi_event_get(&event, jackBuffer, i) != 0) {
+            continue;
+        }
+        int eventSlot = slot(event);
+        if(eventSlot < 0) {
+            continue;
+        }
+        quint32 eventWindow = window > 0 ? event.time / window : 0;
+        lastWindow = qMax(lastWindow, eventWindow);
+        quint32 stamp = _generation + eventWindow;
+        if(_stamps[eventSlot] == stamp) {
+            _keep[i] = 0;
+        } else {
+            _stamps[eventSlot] = stamp;
+        }
+    }
+
+    // Advance past all stamps used, starting over before they wrap.
+    if(_generation + lastWindow + 1 < _generation) {
+        std::fill(_stamps.begin(), _stamps.end(), 0);
+        _generation = 1;
+    } else {
+        _generation += lastWindow + 1;
+    }
+
+    int coalesced = 0;
+    for(int i = 0; i < numberOfEvents; i++) {
+        if(i < numberOfTrackedEvents && !_keep[i]) {
+            coalesced++;
+            continue;
+        }
+        if(jack_midi_event_get(&event, jackBuffer, i) == 0) {
+            target.writeEvent(event.time, event.buffer, event.size);
+        }
+    }
+
+    _coalescedEvents.fetch_add(coalesced, std::memory_order_relaxed);
+    return coalesced;
+}
+
+quint64 MidiCoalescer::numberOfCoalescedEvents() const {
+    return _coalescedEvents.load(std::memory_order_relaxed);
+}
+
+int MidiCoalescer::slot(const jack_midi_event_t& event) const {
+    if(event.size < 2) {
+        return -1;
+    }
+    int channel = event.buffer[0] & 0x0f;
+    switch(event.buffer[0] & 0xf0) {
+    case 0xa0:
+        return event.size == 3 ? PolyPressureSlots + channel * 128 + (event.buffer[1] & 0x7f) : -1;
+    case 0xb0:
+        if(event.size != 3 || !isControllerCoalesced(event.buffer[1] & 0x7f)) {
+            return -1;
+        }
+        return ControlChangeSlots + channel * 128 + (event.buffer[1] & 0x7f);
+    case 0xd0:
+        return ChannelPressureSlots + channel;
+    case 0xe0:
+        return event.size == 3 ? PitchBendSlots + channel : -1;
+    default:
+        return -1;
+    }
+}
+
+} // namespace QtJack
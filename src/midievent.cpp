@@ -28,10 +28,13 @@
 namespace QtJack {
 
 MidiEvent::MidiEvent() {
+    time = 0;
+    size = 0;
+    buffer = 0;
 }
 
 MidiEvent::~MidiEvent() {
-    delete[] this->buffer;
+    // The buffer is owned by JACK.
 }
 
 } // namespace QtJack
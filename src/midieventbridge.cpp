@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "midieventbridge.h"
+
+namespace QtJack {
+
+MidiEventBridge::MidiEventBridge(int numberOfBytes, QObject *parent)
+    : QObject(parent),
+      _ringBuffer(numberOfBytes) {
+    connect(&_timer, &QTimer::timeout, this, &MidiEventBridge::poll);
+}
+
+MidiEventBridge::~MidiEventBridge() {
+}
+
+bool MidiEventBridge::collect(const MidiBuffer& buffer, quint32 frameTime) {
+    return buffer.push(_ringBuffer, frameTime);
+}
+
+quint64 MidiEventBridge::numberOfDroppedEvents() const {
+    return _ringBuffer.numberOfDroppedMessages();
+}
+
+void MidiEventBridge::startPolling(int milliseconds) {
+    _timer.start(milliseconds);
+}
+
+void MidiEventBridge::stopPolling() {
+    _timer.stop();
+}
+
+bool MidiEventBridge::poll() {
+    // Records are larger than their messages and take at least a header,
+    // so the records readable now fit into one allocation each. Records
+    // written meanwhile are left for the next poll.
+    int numberOfBytes = _ringBuffer.numberOfBytesAvailableForRead();
+    int maximumNumberOfEvents = numberOfBytes / (int)sizeof(MidiRecordHeader);
+
+    MidiEventBatch batch;
+    batch._events.reserve(maximumNumberOfEvents);
+    batch._data.reserve(numberOfBytes);
+    MidiEventBatch::Event event;
+    while(batch._events.size() < maximumNumberOfEvents
+       && _ringBuffer.peek(event._time, event._size)
+       && batch._data.size() + event._size <= numberOfBytes) {
+        event._offset = batch._data.size();
+        batch._data.resize(event._offset + event._size);
+        _ringBuffer.read(event._time, (MidiData*)batch._data.data() + event._offset,
+                         event._size, event._size);
+        batch._events.append(event);
+    }
+
+    if(batch.isEmpty()) {
+        return false;
+    }
+    Q_EMIT eventsReceived(batch);
+    return true;
+}
+
+} // namespace QtJack
@@ -0,0 +1,245 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "midimap.h"
+
+// Standard includes
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace QtJack {
+
+static const int NoNrpn = -1;
+
+MidiMap::MidiMap(Reclaimer& reclaimer)
+    : _tables(reclaimer) {
+    Table *table = new Table;
+    table->_firstEntry.assign(NumberOfSlots + 1, 0);
+    _tables.publish(table);
+    _lastControlChange = -1;
+    for(int channel = 0; channel < 16; channel++) {
+        memset(_channels[channel]._controllers, 0, sizeof(_channels[channel]._controllers));
+        _channels[channel]._nrpn = NoNrpn;
+    }
+}
+
+MidiMap::~MidiMap() {
+}
+
+void MidiMap::setMappings(const QVector<MidiMapping>& mappings) {
+    _mappings = mappings;
+
+    // Collect the entries of each slot, then lay them out flat.
+    std::vector<std::vector<Entry> > slots(NumberOfSlots);
+    Table *table = new Table;
+    Q_FOREACH(const MidiMapping& mapping, mappings) {
+        if(!mapping._target || mapping._channel < 0 || mapping._channel > 15) {
+            continue;
+        }
+        int channelSlot = mapping._channel * 128;
+        switch(mapping._source) {
+        case MidiMapping::ControlChange:
+            if(mapping._number >= 0 && mapping._number < 128) {
+                slots[ControlChangeSlots + channelSlot + mapping._number].push_back(compile(mapping, SevenBit));
+            }
+            break;
+        case MidiMapping::ControlChange14Bit:
+            if(mapping._number >= 0 && mapping._number < 32) {
+                slots[ControlChangeSlots + channelSlot + mapping._number].push_back(compile(mapping, MostSignificant));
+                slots[ControlChangeSlots + channelSlot + mapping._number + 32].push_back(compile(mapping, LeastSignificant));
+            }
+            break;
+        case MidiMapping::Nrpn:
+            if(mapping._number >= 0 && mapping._number < 16384) {
+                Entry entry = compile(mapping, FourteenBit);
+                entry._key = mapping._channel * 16384 + mapping._number;
+                table->_nrpnEntries.push_back(entry);
+            }
+            break;
+        case MidiMapping::PitchBend:
+            slots[PitchBendSlots + mapping._channel].push_back(compile(mapping, FourteenBit));
+            break;
+        case MidiMapping::ChannelPressure:
+            slots[ChannelPressureSlots + mapping._channel].push_back(compile(mapping, SevenBit));
+            break;
+        }
+    }
+
+    table->_firstEntry.reserve(NumberOfSlots + 1);
+    for(int slot = 0; slot < NumberOfSlots; slot++) {
+        table->_firstEntry.push_back((int)table->_entries.size());
+        table->_entries.insert(table->_entries.end(), slots[slot].begin(), slots[slot].end());
+    }
+    table->_firstEntry.push_back((int)table->_entries.size());
+    std::stable_sort(table->_nrpnEntries.begin(), table->_nrpnEntries.end(),
+                     [](const Entry& a, const Entry& b) { return a._key < b._key; });
+
+    _tables.publish(table);
+}
+
+int MidiMap::process(const MidiBuffer& buffer) {
+    const Table& table = *_tables.acquire();
+
+    int updates = 0;
+    for(MidiEventView event : buffer) {
+        if(event.size() < 2) {
+            continue;
+        }
+        int channel = event.channel();
+        switch(event.status() & 0xf0) {
+        case 0xb0:
+            if(event.size() == 3) {
+                updates += controlChange(table, channel, event[1] & 0x7f, event[2] & 0x7f);
+            }
+            break;
+        case 0xd0:
+            updates += dispatch(table, ChannelPressureSlots + channel, event[1] & 0x7f, 127, channel);
+            break;
+        case 0xe0:
+            if(event.size() == 3) {
+                int value = (event[1] & 0x7f) | ((event[2] & 0x7f) << 7);
+                updates += dispatch(table, PitchBendSlots + channel, value, 16383, channel);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return updates;
+}
+
+int MidiMap::lastControlChange() const {
+    return _lastControlChange.load(std::memory_order_relaxed);
+}
+
+MidiMap::Entry MidiMap::compile(const MidiMapping& mapping, int kind) {
+    Entry entry;
+    entry._target = mapping._target;
+    entry._kind = kind;
+    entry._controller = mapping._number;
+    entry._key = 0;
+    entry._curveType = mapping._curve;
+
+    // Steepness of the exponential and logarithmic curves.
+    const double k = 4.0;
+    for(int i = 0; i < CurveSize; i++) {
+        double x = i / (double)(CurveSize - 1);
+        switch(mapping._curve) {
+        case MidiMapping::Linear:
+        default:
+            break;
+        case MidiMapping::Exponential:
+            x = (std::exp(k * x) - 1.0) / (std::exp(k) - 1.0);
+            break;
+        case MidiMapping::Logarithmic:
+            x = std::log(1.0 + (std::exp(k) - 1.0) * x) / k;
+            break;
+        case MidiMapping::Toggle:
+            x = x >= 0.5 ? 1.0 : 0.0;
+            break;
+        }
+        entry._curve[i] = (float)(mapping._minimum + (mapping._maximum - mapping._minimum) * x);
+    }
+    return entry;
+}
+
+float MidiMap::valueOf(const Entry& entry, int value, int maximum) {
+    if(maximum == CurveSize - 1) {
+        return entry._curve[value];
+    }
+    float position = value * (float)(CurveSize - 1) / maximum;
+    if(entry._curveType == MidiMapping::Toggle) {
+        // Snap to the nearest point, so toggles only take both extremes.
+        return entry._curve[(int)(position + 0.5f)];
+    }
+    // Interpolate finer controllers between the points of the curve.
+    int index = (int)position;
+    if(index >= CurveSize - 1) {
+        return entry._curve[CurveSize - 1];
+    }
+    float fraction = position - index;
+    return entry._curve[index] + (entry._curve[index + 1] - entry._curve[index]) * fraction;
+}
+
+int MidiMap::dispatch(const Table& table, int slot, int value, int maximum, int channel) {
+    int updates = 0;
+    for(int i = table._firstEntry[slot]; i < table._firstEntry[slot + 1]; i++) {
+        const Entry& entry = table._entries[i];
+        float parameterValue;
+        if(entry._kind == SevenBit || entry._kind == FourteenBit) {
+            parameterValue = valueOf(entry, value, maximum);
+        } else {
+            const quint8 *controllers = _channels[channel]._controllers;
+            int fineValue = (controllers[entry._controller] << 7) | controllers[entry._controller + 32];
+            parameterValue = valueOf(entry, fineValue, 16383);
+        }
+        entry._target->store(parameterValue, std::memory_order_relaxed);
+        updates++;
+    }
+    return updates;
+}
+
+int MidiMap::controlChange(const Table& table, int channel, int controller, int value) {
+    _lastControlChange.store(channel * 128 + controller, std::memory_order_relaxed);
+
+    ChannelState& state = _channels[channel];
+    state._controllers[controller] = (quint8)value;
+    // A new most significant value starts over with a zero LSB.
+    if(controller < 32) {
+        state._controllers[controller + 32] = 0;
+    }
+
+    switch(controller) {
+    case 99: // NRPN MSB
+    case 98: // NRPN LSB
+        state._nrpn = (state._controllers[99] << 7) | state._controllers[98];
+        break;
+    case 101: // RPN MSB
+    case 100: // RPN LSB
+        state._nrpn = NoNrpn;
+        break;
+    default:
+        break;
+    }
+
+    int updates = dispatch(table, ControlChangeSlots + channel * 128 + controller, value, 127, channel);
+
+    // Data entry applies to the selected NRPN.
+    if((controller == 6 || controller == 38) && state._nrpn != NoNrpn && !table._nrpnEntries.empty()) {
+        int key = channel * 16384 + state._nrpn;
+        int fineValue = (state._controllers[6] << 7) | state._controllers[38];
+        std::vector<Entry>::const_iterator entry = std::lower_bound(
+            table._nrpnEntries.begin(), table._nrpnEntries.end(), key,
+            [](const Entry& e, int k) { return e._key < k; });
+        for(; entry != table._nrpnEntries.end() && entry->_key == key; ++entry) {
+            entry->_target->store(valueOf(*entry, fineValue, 16383), std::memory_order_relaxed);
+            updates++;
+        }
+    }
+    return updates;
+}
+
+} // namespace QtJack
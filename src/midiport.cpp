@@ -50,7 +50,7 @@ MidiBuffer MidiPort::buffer(int samples) const {
     if(isValid()) {
         return MidiBuffer(samples, jack_port_get_buffer(_jackPort, samples));
     }
-    return MidiBuffer(samples, 0);
+    return MidiBuffer(samples, (void*)0);
 }
 
 } // namespace QtJack
@@ -0,0 +1,143 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "midirecordringbuffer.h"
+
+namespace QtJack {
+
+static_assert(sizeof(MidiRecordHeader) == 8, "short MIDI records must take eight bytes");
+
+MidiRecordRingBuffer::MidiRecordRingBuffer(int numberOfBytes)
+    : _ringBuffer(numberOfBytes) {
+    _droppedMessages = 0;
+}
+
+bool MidiRecordRingBuffer::write(quint32 time, const MidiData *data, int size) {
+    if(size < 0) {
+        return false;
+    }
+
+    MidiRecordHeader header;
+    header._time = time;
+    header._size = size <= MidiRecordHeader::InlineSize ? (quint8)size : (quint8)MidiRecordHeader::LongRecord;
+    for(int i = 0; i < MidiRecordHeader::InlineSize; i++) {
+        header._data[i] = i < size ? data[i] : 0;
+    }
+
+    int recordSize = sizeof(header);
+    if(header._size == MidiRecordHeader::LongRecord) {
+        recordSize += sizeof(quint32) + size;
+    }
+
+    MidiRingBuffer::Vector vector = _ringBuffer.writeVector();
+    if(vector.numberOfElements() < recordSize) {
+        _droppedMessages.store(_droppedMessages.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+        return false;
+    }
+
+    vector.copyIn(0, (const MidiData*)&header, sizeof(header));
+    if(header._size == MidiRecordHeader::LongRecord) {
+        quint32 length = size;
+        vector.copyIn(sizeof(header), (const MidiData*)&length, sizeof(length));
+        vector.copyIn(sizeof(header) + sizeof(length), data, size);
+    }
+    _ringBuffer.writeAdvance(recordSize);
+    return true;
+}
+
+bool MidiRecordRingBuffer::peek(quint32& time, int& size) const {
+    MidiRecordHeader header;
+    if(readHeader(_ringBuffer.readVector(), header, size) == 0) {
+        return false;
+    }
+    time = header._time;
+    return true;
+}
+
+bool MidiRecordRingBuffer::read(quint32& time, MidiData *data, int maximumSize, int& size) {
+    MidiRingBuffer::Vector vector = _ringBuffer.readVector();
+    MidiRecordHeader header;
+    int headerSize = readHeader(vector, header, size);
+    if(headerSize == 0) {
+        return false;
+    }
+
+    time = header._time;
+    int count = size < maximumSize ? size : maximumSize;
+    if(header._size == MidiRecordHeader::LongRecord) {
+        vector.copyOut(headerSize, data, count);
+        _ringBuffer.readAdvance(headerSize + size);
+    } else {
+        for(int i = 0; i < count; i++) {
+            data[i] = header._data[i];
+        }
+        _ringBuffer.readAdvance(headerSize);
+    }
+    return true;
+}
+
+bool MidiRecordRingBuffer::read(quint32& time, QByteArray& data) {
+    int size;
+    if(!peek(time, size)) {
+        return false;
+    }
+    data.resize(size);
+    return read(time, (MidiData*)data.data(), size, size);
+}
+
+bool MidiRecordRingBuffer::skip() {
+    MidiRecordHeader header;
+    int size;
+    int headerSize = readHeader(_ringBuffer.readVector(), header, size);
+    if(headerSize == 0) {
+        return false;
+    }
+    _ringBuffer.readAdvance(header._size == MidiRecordHeader::LongRecord ? headerSize + size : headerSize);
+    return true;
+}
+
+quint64 MidiRecordRingBuffer::numberOfDroppedMessages() const {
+    return _droppedMessages.load(std::memory_order_relaxed);
+}
+
+int MidiRecordRingBuffer::readHeader(const MidiRingBuffer::Vector& vector, MidiRecordHeader& header, int& size) const {
+    if(vector.numberOfElements() < (int)sizeof(header)) {
+        return 0;
+    }
+    vector.copyOut(0, (MidiData*)&header, sizeof(header));
+    if(header._size != MidiRecordHeader::LongRecord) {
+        size = header._size;
+        return sizeof(header);
+    }
+
+    // Records are published as a whole, so the length is always there.
+    quint32 length;
+    vector.copyOut(sizeof(header), (MidiData*)&length, sizeof(length));
+    size = (int)length;
+    return sizeof(header) + sizeof(length);
+}
+
+} // namespace QtJack
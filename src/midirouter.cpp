@@ -0,0 +1,188 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "midirouter.h"
+
+namespace QtJack {
+
+MidiRouter::MidiRouter(const QVector<MidiPort>& inputs, const QVector<MidiPort>& outputs,
+                       Reclaimer& reclaimer)
+    : _inputs(inputs),
+      _outputs(outputs),
+      _tables(reclaimer),
+      _inputBuffers(inputs.size(), (void*)0),
+      _outputBuffers(outputs.size(), (void*)0),
+      _events(inputs.size()),
+      _nextEvent(inputs.size(), 0),
+      _numberOfEvents(inputs.size(), 0),
+      _heap(inputs.size(), 0) {
+    RouteTable *table = new RouteTable;
+    table->_firstRoute.assign(inputs.size() + 1, 0);
+    _tables.publish(table);
+    _heapSize = 0;
+}
+
+MidiRouter::~MidiRouter() {
+}
+
+void MidiRouter::setRoutes(const QVector<MidiRoute>& routes) {
+    _routes = routes;
+
+    RouteTable *table = new RouteTable;
+    table->_firstRoute.reserve(_inputs.size() + 1);
+    for(int input = 0; input < _inputs.size(); input++) {
+        table->_firstRoute.push_back((int)table->_routes.size());
+        Q_FOREACH(const MidiRoute& route, routes) {
+            if(route._input == input && route._output >= 0 && route._output < _outputs.size()) {
+                table->_routes.push_back(route);
+            }
+        }
+    }
+    table->_firstRoute.push_back((int)table->_routes.size());
+    _tables.publish(table);
+}
+
+void MidiRouter::process(int samples) {
+    const RouteTable& table = *_tables.acquire();
+
+    for(int output = 0; output < _outputs.size(); output++) {
+        _outputBuffers[output] = _outputs[output].buffer(samples).internalMemory();
+        if(_outputBuffers[output]) {
+            jack_midi_clear_buffer(_outputBuffers[output]);
+        }
+    }
+
+    // Only inputs with routes take part in the merge.
+    _heapSize = 0;
+    for(int input = 0; input < _inputs.size(); input++) {
+        if(table._firstRoute[input] == table._firstRoute[input + 1]) {
+            continue;
+        }
+        void *jackBuffer = _inputs[input].buffer(samples).internalMemory();
+        _inputBuffers[input] = jackBuffer;
+        if(!jackBuffer) {
+            continue;
+        }
+        _numberOfEvents[input] = (int)jack_midi_get_event_count(jackBuffer);
+        _nextEvent[input] = 1;
+        if(_numberOfEvents[input] > 0 && jack_midi_event_get(&_events[input], jackBuffer, 0) == 0) {
+            _heap[_heapSize++] = input;
+        }
+    }
+    for(int position = _heapSize / 2 - 1; position >= 0; position--) {
+        siftDown(position);
+    }
+
+    while(_heapSize > 0) {
+        int input = _heap[0];
+        route(table, input, _events[input]);
+
+        void *jackBuffer = _inputBuffers[input];
+        bool hasNextEvent = false;
+        while(!hasNextEvent && _nextEvent[input] < _numberOfEvents[input]) {
+            hasNextEvent = jack_midi_event_get(&_events[input], jackBuffer, _nextEvent[input]++) == 0;
+        }
+        if(!hasNextEvent) {
+            _heap[0] = _heap[--_heapSize];
+        }
+        siftDown(0);
+    }
+}
+
+void MidiRouter::route(const RouteTable& table, int input, const jack_midi_event_t& event) {
+    if(event.size == 0 || event.buffer[0] < 0x80) {
+        return;
+    }
+
+    MidiData status = event.buffer[0];
+    quint8 type = (quint8)(1 << ((status >> 4) - 8));
+    bool isChannelMessage = status < 0xf0;
+    bool isNoteMessage = status < 0xb0 && event.size >= 2;
+
+    for(int i = table._firstRoute[input]; i < table._firstRoute[input + 1]; i++) {
+        const MidiRoute& route = table._routes[i];
+        if(!(route._types & type)) {
+            continue;
+        }
+        if(isChannelMessage && !(route._channels & (1 << (status & 0x0f)))) {
+            continue;
+        }
+        if(isNoteMessage && (event.buffer[1] < route._lowestNote || event.buffer[1] > route._highestNote)) {
+            continue;
+        }
+
+        void *output = _outputBuffers[route._output];
+        if(!output) {
+            continue;
+        }
+        if(!isChannelMessage || event.size > 3 || (route._channel < 0 && route._transpose == 0)) {
+            jack_midi_event_write(output, event.time, event.buffer, event.size);
+            continue;
+        }
+
+        MidiData data[3];
+        for(size_t j = 0; j < event.size; j++) {
+            data[j] = event.buffer[j];
+        }
+        if(route._channel >= 0) {
+            data[0] = (MidiData)((status & 0xf0) | (route._channel & 0x0f));
+        }
+        if(isNoteMessage) {
+            int note = data[1] + route._transpose;
+            if(note < 0 || note > 127) {
+                continue;
+            }
+            data[1] = (MidiData)note;
+        }
+        jack_midi_event_write(output, event.time, data, event.size);
+    }
+}
+
+void MidiRouter::siftDown(int position) {
+    for(;;) {
+        int child = 2 * position + 1;
+        if(child >= _heapSize) {
+            return;
+        }
+        if(child + 1 < _heapSize && isEarlier(_heap[child + 1], _heap[child])) {
+            child++;
+        }
+        if(!isEarlier(_heap[child], _heap[position])) {
+            return;
+        }
+        int input = _heap[position];
+        _heap[position] = _heap[child];
+        _heap[child] = input;
+        position = child;
+    }
+}
+
+bool MidiRouter::isEarlier(int a, int b) const {
+    // Ties go to the lower input, so merging is deterministic.
+    return _events[a].time < _events[b].time
+       || (_events[a].time == _events[b].time && a < b);
+}
+
+} // namespace QtJack
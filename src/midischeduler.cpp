@@ -0,0 +1,147 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "midischeduler.h"
+
+namespace QtJack {
+
+MidiScheduler::MidiScheduler(int capacity) {
+    _capacity = capacity > 0 ? capacity : 1;
+    _heap = new ScheduledMidiEvent[_capacity];
+    _size = 0;
+    _order = 0;
+    _droppedEvents = 0;
+}
+
+MidiScheduler::~MidiScheduler() {
+    delete[] _heap;
+}
+
+bool MidiScheduler::schedule(quint32 frameTime, const MidiData *data, int size) {
+    if(size <= 0 || size > ScheduledMidiEvent::MaximumSize) {
+        return false;
+    }
+
+    ScheduledMidiEvent event;
+    event._time = frameTime;
+    event._order = 0;
+    event._size = (quint8)size;
+    for(int i = 0; i < ScheduledMidiEvent::MaximumSize; i++) {
+        event._data[i] = i < size ? data[i] : 0;
+    }
+
+    if(!_queue.push(event)) {
+        _droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool MidiScheduler::process(MidiBuffer& buffer, quint32 frameTime, int frames) {
+    bool success = collect();
+
+    int lastSample = 0;
+    while(_size > 0) {
+        const ScheduledMidiEvent& event = _heap[0];
+        int sample = (int)(qint32)(event._time - frameTime);
+        if(sample >= frames) {
+            break;
+        }
+        // Late events are played as soon as possible.
+        if(sample < lastSample) {
+            sample = lastSample;
+        }
+        if(!buffer.writeEvent(sample, (MidiData*)event._data, event._size)) {
+            _droppedEvents.fetch_add(1, std::memory_order_relaxed);
+            success = false;
+        }
+        lastSample = sample;
+        removeFirst();
+    }
+    return success;
+}
+
+void MidiScheduler::clear() {
+    ScheduledMidiEvent event;
+    while(_queue.pop(event)) {
+    }
+    _size = 0;
+}
+
+quint64 MidiScheduler::numberOfDroppedEvents() const {
+    return _droppedEvents.load(std::memory_order_relaxed);
+}
+
+bool MidiScheduler::collect() {
+    bool success = true;
+    ScheduledMidiEvent event;
+    while(_queue.pop(event)) {
+        if(_size == _capacity) {
+            _droppedEvents.fetch_add(1, std::memory_order_relaxed);
+            success = false;
+            continue;
+        }
+        event._order = _order++;
+        insert(event);
+    }
+    return success;
+}
+
+void MidiScheduler::insert(const ScheduledMidiEvent& event) {
+    int i = _size++;
+    while(i > 0) {
+        int parent = (i - 1) / 2;
+        if(!isEarlier(event, _heap[parent])) {
+            break;
+        }
+        _heap[i] = _heap[parent];
+        i = parent;
+    }
+    _heap[i] = event;
+}
+
+void MidiScheduler::removeFirst() {
+    ScheduledMidiEvent last = _heap[--_size];
+    int i = 0;
+    for(;;) {
+        int child = 2 * i + 1;
+        if(child >= _size) {
+            break;
+        }
+        if(child + 1 < _size && isEarlier(_heap[child + 1], _heap[child])) {
+            child++;
+        }
+        if(!isEarlier(_heap[child], last)) {
+            break;
+        }
+        _heap[i] = _heap[child];
+        i = child;
+    }
+    if(_size > 0) {
+        _heap[i] = last;
+    }
+}
+
+} // namespace QtJack
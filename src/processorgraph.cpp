@@ -0,0 +1,233 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "processorgraph.h"
+
+namespace QtJack {
+
+ProcessorGraph::ProcessorGraph(Client& client, Reclaimer& reclaimer) :
+    Processor(client),
+    _plans(reclaimer),
+    _generation(0) {
+    _activeGeneration = 0;
+    // JACK reports buffer size changes on its own thread.
+    QObject::connect(&client, &Client::bufferSizeChanged,
+                     &_context, [this](int) { compile(); },
+                     Qt::QueuedConnection);
+}
+
+ProcessorGraph::~ProcessorGraph() {
+}
+
+int ProcessorGraph::addProcessor(GraphProcessor *processor) {
+    _processors.append(processor);
+    return _processors.size() - 1;
+}
+
+void ProcessorGraph::removeProcessor(int node) {
+    if(!isValidNode(node)) {
+        return;
+    }
+    // Keep the slot, so that the other nodes stay valid.
+    _processors[node] = 0;
+    for(int i = _connections.size() - 1; i >= 0; i--) {
+        if(_connections[i]._sourceNode == node || _connections[i]._targetNode == node) {
+            _connections.removeAt(i);
+        }
+    }
+}
+
+GraphProcessor *ProcessorGraph::processor(int node) const {
+    return isValidNode(node) ? _processors[node] : 0;
+}
+
+bool ProcessorGraph::connect(int sourceNode, int output, int targetNode, int input) {
+    if(!isValidNode(sourceNode) || !isValidNode(targetNode)
+    || output < 0 || output >= _processors[sourceNode]->numberOfOutputs()
+    || input < 0 || input >= _processors[targetNode]->numberOfInputs()) {
+        return false;
+    }
+
+    disconnect(targetNode, input);
+    Connection connection;
+    connection._sourceNode = sourceNode;
+    connection._output = output;
+    connection._targetNode = targetNode;
+    connection._input = input;
+    _connections.append(connection);
+    return true;
+}
+
+void ProcessorGraph::disconnect(int targetNode, int input) {
+    for(int i = _connections.size() - 1; i >= 0; i--) {
+        if(_connections[i]._targetNode == targetNode && _connections[i]._input == input) {
+            _connections.removeAt(i);
+        }
+    }
+}
+
+bool ProcessorGraph::compile() {
+    int numberOfNodes = _processors.size();
+
+    // Kahn's algorithm.
+    QVector<int> dependencies(numberOfNodes, 0);
+    QVector<QVector<int> > dependents(numberOfNodes);
+    Q_FOREACH(const Connection& connection, _connections) {
+        if(connection._sourceNode != connection._targetNode
+        && !dependents[connection._sourceNode].contains(connection._targetNode)) {
+            dependents[connection._sourceNode].append(connection._targetNode);
+            dependencies[connection._targetNode]++;
+        } else if(connection._sourceNode == connection._targetNode) {
+            return false;
+        }
+    }
+
+    QVector<int> order;
+    for(int node = 0; node < numberOfNodes; node++) {
+        if(_processors[node] && dependencies[node] == 0) {
+            order.append(node);
+        }
+    }
+    for(int i = 0; i < order.size(); i++) {
+        Q_FOREACH(int dependent, dependents[order[i]]) {
+            if(--dependencies[dependent] == 0) {
+                order.append(dependent);
+            }
+        }
+    }
+
+    int numberOfProcessors = 0;
+    Q_FOREACH(GraphProcessor *processor, _processors) {
+        numberOfProcessors += processor ? 1 : 0;
+    }
+    if(order.size() < numberOfProcessors) {
+        return false;
+    }
+
+    // Assign a buffer to each output, in execution order. A buffer is free
+    // again once all inputs reading it have run.
+    QVector<QVector<int> > outputBuffers(numberOfNodes);
+    QVector<QVector<int> > readers(numberOfNodes);
+    for(int node = 0; node < numberOfNodes; node++) {
+        if(_processors[node]) {
+            outputBuffers[node].fill(-1, _processors[node]->numberOfOutputs());
+            readers[node].fill(0, _processors[node]->numberOfOutputs());
+        }
+    }
+    Q_FOREACH(const Connection& connection, _connections) {
+        readers[connection._sourceNode][connection._output]++;
+    }
+
+    QVector<int> freeBuffers;
+    int numberOfBuffers = 0;
+    int numberOfInputs = 0;
+    int numberOfOutputs = 0;
+    Q_FOREACH(int node, order) {
+        GraphProcessor *processor = _processors[node];
+        numberOfInputs += processor->numberOfInputs();
+        numberOfOutputs += processor->numberOfOutputs();
+
+        for(int output = 0; output < processor->numberOfOutputs(); output++) {
+            if(freeBuffers.isEmpty()) {
+                outputBuffers[node][output] = numberOfBuffers++;
+            } else {
+                outputBuffers[node][output] = freeBuffers.takeLast();
+            }
+        }
+        Q_FOREACH(const Connection& connection, _connections) {
+            if(connection._targetNode == node
+            && --readers[connection._sourceNode][connection._output] == 0) {
+                freeBuffers.append(outputBuffers[connection._sourceNode][connection._output]);
+            }
+        }
+        for(int output = 0; output < processor->numberOfOutputs(); output++) {
+            if(readers[node][output] == 0) {
+                freeBuffers.append(outputBuffers[node][output]);
+            }
+        }
+    }
+
+    // One more buffer stays silent for unconnected inputs.
+    Plan *plan = new Plan(_client, numberOfBuffers + 1, ++_generation);
+    for(int i = 0; i <= numberOfBuffers; i++) {
+        plan->_buffers.push_back(plan->_pool.acquireAudioBuffer());
+    }
+    plan->_buffers.back().clear();
+
+    plan->_inputs.reserve(numberOfInputs);
+    plan->_outputs.reserve(numberOfOutputs);
+    Q_FOREACH(int node, order) {
+        GraphProcessor *processor = _processors[node];
+        Step step;
+        step._processor = processor;
+        step._inputs = plan->_inputs.data() + plan->_inputs.size();
+        step._outputs = plan->_outputs.data() + plan->_outputs.size();
+
+        for(int input = 0; input < processor->numberOfInputs(); input++) {
+            int buffer = numberOfBuffers;
+            Q_FOREACH(const Connection& connection, _connections) {
+                if(connection._targetNode == node && connection._input == input) {
+                    buffer = outputBuffers[connection._sourceNode][connection._output];
+                }
+            }
+            plan->_inputs.push_back(plan->_buffers[buffer]);
+        }
+        for(int output = 0; output < processor->numberOfOutputs(); output++) {
+            plan->_outputs.push_back(plan->_buffers[outputBuffers[node][output]]);
+        }
+        plan->_steps.push_back(step);
+    }
+
+    _plans.publish(plan);
+    return true;
+}
+
+void ProcessorGraph::process(int samples) {
+    const Plan *plan = _plans.acquire();
+    if(!plan) {
+        return;
+    }
+    _activeGeneration.store(plan->_generation, std::memory_order_release);
+
+    // Wait for the recompile after the buffer size grew.
+    if(samples > plan->_bufferSize) {
+        return;
+    }
+
+    for(const Step& step : plan->_steps) {
+        step._processor->dispatchCommands(step._processor->commandBudget());
+        step._processor->process(samples, step._inputs, step._outputs);
+    }
+}
+
+bool ProcessorGraph::isPlanActive() const {
+    return _activeGeneration.load(std::memory_order_acquire) == _generation;
+}
+
+bool ProcessorGraph::isValidNode(int node) const {
+    return node >= 0 && node < _processors.size() && _processors[node] != 0;
+}
+
+} // namespace QtJack
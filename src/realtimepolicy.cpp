@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "realtimepolicy.h"
+
+// Standard includes
+#include <alloca.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <xmmintrin.h>
+#endif
+
+namespace QtJack {
+
+RealtimePolicy::RealtimePolicy() {
+    _flushDenormals = false;
+    _stackPrefaultSize = 0;
+    _lockMemory = false;
+}
+
+RealtimePolicy RealtimePolicy::recommended() {
+    RealtimePolicy policy;
+    policy.setFlushDenormals(true);
+    policy.setStackPrefaultSize(64 * 1024);
+    return policy;
+}
+
+int RealtimePolicy::requestedSteps() const {
+    int steps = StepNone;
+    if(_flushDenormals) {
+        steps |= StepFlushDenormals;
+    }
+    if(!_cpuAffinity.isEmpty()) {
+        steps |= StepPinThread;
+    }
+    if(_stackPrefaultSize > 0) {
+        steps |= StepPrefaultStack;
+    }
+    if(_lockMemory) {
+        steps |= StepLockMemory;
+    }
+    return steps;
+}
+
+int RealtimePolicy::apply() const {
+    int steps = StepNone;
+    if(_flushDenormals && applyFlushDenormals()) {
+        steps |= StepFlushDenormals;
+    }
+    if(!_cpuAffinity.isEmpty() && applyCpuAffinity(_cpuAffinity)) {
+        steps |= StepPinThread;
+    }
+    if(_stackPrefaultSize > 0 && applyStackPrefault(_stackPrefaultSize)) {
+        steps |= StepPrefaultStack;
+    }
+    if(_lockMemory && applyLockMemory()) {
+        steps |= StepLockMemory;
+    }
+    return steps;
+}
+
+bool RealtimePolicy::applyFlushDenormals() {
+#if defined(__x86_64__) || defined(__i386__)
+    // Flush to zero (bit 15) and denormals are zero (bit 6) in MXCSR.
+    const unsigned int flags = 0x8040;
+    _mm_setcsr(_mm_getcsr() | flags);
+    return (_mm_getcsr() & flags) == flags;
+#elif defined(__aarch64__)
+    // Flush to zero (bit 24) in FPCR also covers denormal inputs.
+    const unsigned long flag = 1ul << 24;
+    unsigned long fpcr;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr | flag));
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    return (fpcr & flag) != 0;
+#elif defined(__arm__) && defined(__ARM_FP)
+    // Flush to zero (bit 24) in FPSCR.
+    const unsigned int flag = 1u << 24;
+    unsigned int fpscr;
+    __asm__ __volatile__("vmrs %0, fpscr" : "=r"(fpscr));
+    __asm__ __volatile__("vmsr fpscr, %0" : : "r"(fpscr | flag));
+    __asm__ __volatile__("vmrs %0, fpscr" : "=r"(fpscr));
+    return (fpscr & flag) != 0;
+#else
+    return false;
+#endif
+}
+
+bool RealtimePolicy::applyCpuAffinity(QList<int> cpus) {
+#if defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    Q_FOREACH(int cpu, cpus) {
+        if(cpu < 0 || cpu >= CPU_SETSIZE) {
+            return false;
+        }
+        CPU_SET(cpu, &cpuSet);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+    Q_UNUSED(cpus);
+    return false;
+#endif
+}
+
+__attribute__((noinline))
+bool RealtimePolicy::applyStackPrefault(int bytes) {
+    // Touch one byte per page below the current stack frame, so the kernel
+    // maps those pages now instead of during the first cycles.
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if(pageSize <= 0) {
+        pageSize = 4096;
+    }
+    volatile char *stack = (volatile char*)alloca(bytes);
+    for(int i = 0; i < bytes; i += (int)pageSize) {
+        stack[i] = 0;
+    }
+    stack[bytes - 1] = 0;
+    return true;
+}
+
+bool RealtimePolicy::applyLockMemory() {
+    return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+}
+
+} // namespace QtJack
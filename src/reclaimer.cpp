@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "reclaimer.h"
+
+namespace QtJack {
+
+Reclaimer::Reclaimer(QObject *parent)
+    : QObject(parent) {
+    connect(&_timer, &QTimer::timeout, this, &Reclaimer::reclaim);
+    startReclaiming();
+}
+
+Reclaimer::~Reclaimer() {
+    reclaim();
+}
+
+bool Reclaimer::retire(void *object, void (*deleter)(void*)) {
+    if(!object) {
+        return true;
+    }
+    RetiredObject retiredObject = { object, deleter };
+    return _retiredObjects.push(retiredObject);
+}
+
+void Reclaimer::startReclaiming(int milliseconds) {
+    _timer.start(milliseconds);
+}
+
+void Reclaimer::stopReclaiming() {
+    _timer.stop();
+}
+
+int Reclaimer::reclaim() {
+    enum { BatchSize = 64 };
+    RetiredObject batch[BatchSize];
+    int reclaimed = 0;
+    int count;
+    while((count = _retiredObjects.read(batch, BatchSize)) > 0) {
+        for(int i = 0; i < count; i++) {
+            batch[i]._deleter(batch[i]._object);
+        }
+        reclaimed += count;
+    }
+
+    std::shared_ptr<void> sharedObject;
+    while(_sharedObjects.pop(sharedObject)) {
+        sharedObject.reset();
+        reclaimed++;
+    }
+    return reclaimed;
+}
+
+} // namespace QtJack
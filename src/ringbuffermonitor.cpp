@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "ringbuffermonitor.h"
+
+namespace QtJack {
+
+void RingBufferMonitor::initialize(QSharedPointer<RingBufferPrivate> ringBuffer) {
+    _ringBuffer = ringBuffer;
+    _statistics = _ringBuffer->statistics();
+    connect(&_timer, &QTimer::timeout, this, &RingBufferMonitor::poll);
+}
+
+RingBufferMonitor::~RingBufferMonitor() {
+}
+
+void RingBufferMonitor::resetStatistics() {
+    _ringBuffer->resetStatistics();
+    _statistics = _ringBuffer->statistics();
+}
+
+void RingBufferMonitor::startPolling(int milliseconds) {
+    _timer.start(milliseconds);
+}
+
+void RingBufferMonitor::stopPolling() {
+    _timer.stop();
+}
+
+bool RingBufferMonitor::poll() {
+    RingBufferStatistics statistics = _ringBuffer->statistics();
+    // The current fill level alone changes all the time and is not worth
+    // a notification.
+    bool changed = statistics.highWater() != _statistics.highWater()
+                || statistics.lowWater() != _statistics.lowWater()
+                || statistics.failedWrites() != _statistics.failedWrites()
+                || statistics.failedReads() != _statistics.failedReads()
+                || statistics.droppedElements() != _statistics.droppedElements();
+    _statistics = statistics;
+    if(changed) {
+        Q_EMIT statisticsChanged(_statistics);
+    }
+    return changed;
+}
+
+} // namespace QtJack
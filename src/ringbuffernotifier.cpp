@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "ringbuffernotifier.h"
+
+// Standard includes
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+
+namespace QtJack {
+
+void RingBufferPrivate::signalNotification(int fd) {
+    // Eight bytes is what an eventfd expects, a pipe does not care.
+    quint64 one = 1;
+    ssize_t result = ::write(fd, &one, sizeof(one));
+    Q_UNUSED(result);
+}
+
+void RingBufferNotifier::initialize(QSharedPointer<RingBufferPrivate> ringBuffer, int watermarkBytes) {
+    _ringBuffer = ringBuffer;
+    _socketNotifier = 0;
+    _readFd = -1;
+    _writeFd = -1;
+
+#if defined(__linux__)
+    _readFd = _writeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+    int fds[2];
+    if(pipe(fds) == 0) {
+        for(int i = 0; i < 2; i++) {
+            fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+            fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+        }
+        _readFd = fds[0];
+        _writeFd = fds[1];
+    }
+#endif
+    if(_readFd < 0) {
+        return;
+    }
+
+    _socketNotifier = new QSocketNotifier(_readFd, QSocketNotifier::Read, this);
+    // The string based syntax resolves the overloaded activated() signal
+    // of Qt 5.15 as well.
+    connect(_socketNotifier, SIGNAL(activated(int)), this, SLOT(drain()));
+
+    _ringBuffer->_watermark.store(watermarkBytes > 0 ? watermarkBytes : 1, std::memory_order_relaxed);
+    _ringBuffer->_notificationFd.store(_writeFd, std::memory_order_release);
+}
+
+RingBufferNotifier::~RingBufferNotifier() {
+    if(_readFd < 0) {
+        return;
+    }
+
+    _ringBuffer->_notificationFd.store(-1, std::memory_order_release);
+    delete _socketNotifier;
+    if(_writeFd != _readFd) {
+        close(_writeFd);
+    }
+    close(_readFd);
+}
+
+int RingBufferNotifier::watermark() const {
+    return _ringBuffer->_watermark.load(std::memory_order_relaxed) / _bytesPerElement;
+}
+
+void RingBufferNotifier::setWatermark(int watermark) {
+    int watermarkBytes = watermark * _bytesPerElement;
+    _ringBuffer->_watermark.store(watermarkBytes > 0 ? watermarkBytes : 1, std::memory_order_relaxed);
+}
+
+void RingBufferNotifier::drain() {
+    // Reset the descriptor, several signals may have accumulated.
+    char buffer[64];
+    while(::read(_readFd, buffer, sizeof(buffer)) > 0) {
+    }
+    Q_EMIT watermarkReached();
+}
+
+} // namespace QtJack
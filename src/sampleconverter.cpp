@@ -0,0 +1,358 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+//    This file is part of QtJack.                                           //
+//    Copyright (C) 2014-2015 Jacob Dawid <jacob@omg-it.works>               //
+//                                                                           //
+//    QtJack is free software: you can redistribute it and/or modify         //
+//    it under the terms of the GNU General Public License as published by   //
+//    the Free Software Foundation, either version 3 of the License, or      //
+//    (at your option) any later version.                                    //
+//                                                                           //
+//    QtJack is distributed in the hope that it will be useful,              //
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of         //
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          //
+//    GNU General Public License for more details.                           //
+//                                                                           //
+//    You should have received a copy of the GNU General Public License      //
+//    along with QtJack. If not, see <http://www.gnu.org/licenses/>.         //
+//                                                                           //
+//    It is possible to obtain a closed-source license of QtJack.            //
+//    If you're interested, contact me at: jacob@omg-it.works                //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+
+// Own includes
+#include "sampleconverter.h"
+#include "audiokernels.h"
+
+// Standard includes
+#include <cstring>
+
+namespace QtJack {
+
+/** Scale and saturation limits of an integer format. */
+struct IntegerFormat {
+    AudioSample scale;
+    AudioSample minimum;
+    AudioSample maximum;
+};
+
+static IntegerFormat integerFormat(SampleConverter::SampleFormat sampleFormat) {
+    switch(sampleFormat) {
+    case SampleConverter::SampleFormatInt16:
+        return { 32768.0f, -32768.0f, 32767.0f };
+    case SampleConverter::SampleFormatInt24:
+        return { 8388608.0f, -8388608.0f, 8388607.0f };
+    default:
+        // 2^31 - 1 is not representable, use the largest float below.
+        return { 2147483648.0f, -2147483648.0f, 2147483520.0f };
+    }
+}
+
+SampleConverter::SampleConverter(SampleFormat sampleFormat, bool dither) {
+    _sampleFormat = sampleFormat;
+    _dither = dither;
+    _ditherState = 0x9e3779b9;
+}
+
+int SampleConverter::bytesPerSample(SampleFormat sampleFormat) {
+    switch(sampleFormat) {
+    case SampleFormatInt16: return 2;
+    case SampleFormatInt24: return 3;
+    case SampleFormatInt32: return 4;
+    case SampleFormatFloat32: return 4;
+    }
+    return 4;
+}
+
+int SampleConverter::bytesPerFrame(int numberOfChannels) const {
+    return numberOfChannels * bytesPerSample(_sampleFormat);
+}
+
+int SampleConverter::interleave(const AudioSample *const *channels,
+                                int numberOfChannels,
+                                int frames,
+                                void *destination) {
+    int stride = bytesPerFrame(numberOfChannels);
+    int sampleSize = bytesPerSample(_sampleFormat);
+    for(int offset = 0; offset < frames; offset += BlockSize) {
+        int blockSize = qMin((int)BlockSize, frames - offset);
+        char *frame = (char*)destination + offset * stride;
+        for(int c = 0; c < numberOfChannels; c++) {
+            storeChannel(channels[c] + offset, blockSize, frame + c * sampleSize, stride, _sampleFormat);
+        }
+    }
+    return frames;
+}
+
+int SampleConverter::interleave(const AudioBuffer *buffers,
+                                int numberOfChannels,
+                                void *destination) {
+    int frames = -1;
+    for(int c = 0; c < numberOfChannels; c++) {
+        if(!buffers[c].isValid()) {
+            return -1;
+        }
+        frames = (frames < 0 || buffers[c].size() < frames) ? buffers[c].size() : frames;
+    }
+    if(frames <= 0) {
+        return 0;
+    }
+
+    int stride = bytesPerFrame(numberOfChannels);
+    int sampleSize = bytesPerSample(_sampleFormat);
+    for(int offset = 0; offset < frames; offset += BlockSize) {
+        int blockSize = qMin((int)BlockSize, frames - offset);
+        char *frame = (char*)destination + offset * stride;
+        for(int c = 0; c < numberOfChannels; c++) {
+            storeChannel((const AudioSample*)buffers[c].internalMemory() + offset, blockSize,
+                         frame + c * sampleSize, stride, _sampleFormat);
+        }
+    }
+    return frames;
+}
+
+int SampleConverter::interleave(const AudioBuffer *buffers,
+                                int numberOfChannels,
+                                AudioRingBuffer& ringBuffer) {
+    int frames = -1;
+    for(int c = 0; c < numberOfChannels; c++) {
+        if(!buffers[c].isValid()) {
+            return -1;
+        }
+        frames = (frames < 0 || buffers[c].size() < frames) ? buffers[c].size() : frames;
+    }
+    if(frames <= 0) {
+        return 0;
+    }
+
+    // Frames are written straight into the ring buffer memory.
+    AudioRingBuffer::Vector vector = ringBuffer.writeVector();
+    frames = qMin(frames, vector.numberOfElements() / numberOfChannels);
+
+    int stride = numberOfChannels * sizeof(AudioSample);
+    int frame = 0;
+    int skip = 0;
+    for(int s = 0; s < 2 && frame < frames; s++) {
+        AudioSample *data = vector.segment(s).data() + skip;
+        int available = vector.segment(s).numberOfElements() - skip;
+        int count = qMin(available / numberOfChannels, frames - frame);
+        for(int c = 0; c < numberOfChannels; c++) {
+            storeChannel((const AudioSample*)buffers[c].internalMemory() + frame, count,
+                         (char*)(data + c), stride, SampleFormatFloat32);
+        }
+        frame += count;
+
+        // Split a frame wrapping around the end of the ring buffer memory.
+        int remainder = available - count * numberOfChannels;
+        if(frame < frames && remainder > 0) {
+            AudioSample *wrapped = vector.second().data();
+            for(int c = 0; c < numberOfChannels; c++) {
+                AudioSample sample = ((const AudioSample*)buffers[c].internalMemory())[frame];
+                if(c < remainder) {
+                    data[count * numberOfChannels + c] = sample;
+                } else {
+                    wrapped[c - remainder] = sample;
+                }
+            }
+            skip = numberOfChannels - remainder;
+            frame++;
+        }
+    }
+
+    ringBuffer.writeAdvance(frames * numberOfChannels);
+    return frames;
+}
+
+int SampleConverter::deinterleave(const void *source,
+                                  int frames,
+                                  AudioSample *const *channels,
+                                  int numberOfChannels) {
+    int stride = bytesPerFrame(numberOfChannels);
+    int sampleSize = bytesPerSample(_sampleFormat);
+    for(int offset = 0; offset < frames; offset += BlockSize) {
+        int blockSize = qMin((int)BlockSize, frames - offset);
+        const char *frame = (const char*)source + offset * stride;
+        for(int c = 0; c < numberOfChannels; c++) {
+            loadChannel(frame + c * sampleSize, stride, blockSize, channels[c] + offset, _sampleFormat);
+        }
+    }
+    return frames;
+}
+
+int SampleConverter::deinterleave(const void *source,
+                                  int frames,
+                                  AudioBuffer *buffers,
+                                  int numberOfChannels) {
+    for(int c = 0; c < numberOfChannels; c++) {
+        if(!buffers[c].isValid()) {
+            return -1;
+        }
+        frames = qMin(frames, buffers[c].size());
+    }
+    if(frames <= 0) {
+        return 0;
+    }
+
+    int stride = bytesPerFrame(numberOfChannels);
+    int sampleSize = bytesPerSample(_sampleFormat);
+    for(int offset = 0; offset < frames; offset += BlockSize) {
+        int blockSize = qMin((int)BlockSize, frames - offset);
+        const char *frame = (const char*)source + offset * stride;
+        for(int c = 0; c < numberOfChannels; c++) {
+            loadChannel(frame + c * sampleSize, stride, blockSize,
+                        (AudioSample*)buffers[c].internalMemory() + offset, _sampleFormat);
+        }
+    }
+    return frames;
+}
+
+int SampleConverter::deinterleave(AudioRingBuffer& ringBuffer,
+                                  AudioBuffer *buffers,
+                                  int numberOfChannels) {
+    if(numberOfChannels <= 0) {
+        return 0;
+    }
+
+    // Frames are read straight from the ring buffer memory.
+    AudioRingBuffer::Vector vector = ringBuffer.readVector();
+    int frames = vector.numberOfElements() / numberOfChannels;
+    for(int c = 0; c < numberOfChannels; c++) {
+        if(!buffers[c].isValid()) {
+            return -1;
+        }
+        frames = qMin(frames, buffers[c].size());
+    }
+    if(frames <= 0) {
+        return 0;
+    }
+
+    int stride = numberOfChannels * sizeof(AudioSample);
+    int frame = 0;
+    int skip = 0;
+    for(int s = 0; s < 2 && frame < frames; s++) {
+        const AudioSample *data = vector.segment(s).data() + skip;
+        int available = vector.segment(s).numberOfElements() - skip;
+        int count = qMin(available / numberOfChannels, frames - frame);
+        for(int c = 0; c < numberOfChannels; c++) {
+            loadChannel((const char*)(data + c), stride, count,
+                        (AudioSample*)buffers[c].internalMemory() + frame, SampleFormatFloat32);
+        }
+        frame += count;
+
+        // Join a frame wrapping around the end of the ring buffer memory.
+        int remainder = available - count * numberOfChannels;
+        if(frame < frames && remainder > 0) {
+            const AudioSample *wrapped = vector.second().data();
+            for(int c = 0; c < numberOfChannels; c++) {
+                ((AudioSample*)buffers[c].internalMemory())[frame] = c < remainder
+                    ? data[count * numberOfChannels + c]
+                    : wrapped[c - remainder];
+            }
+            skip = numberOfChannels - remainder;
+            frame++;
+        }
+    }
+
+    ringBuffer.readAdvance(frames * numberOfChannels);
+    return frames;
+}
+
+void SampleConverter::storeChannel(const AudioSample *channel, int frames, char *destination,
+                                   int stride, SampleFormat sampleFormat) {
+    if(sampleFormat == SampleFormatFloat32) {
+        for(int i = 0; i < frames; i++) {
+            memcpy(destination + i * stride, channel + i, sizeof(AudioSample));
+        }
+        return;
+    }
+
+    // Convert the contiguous channel block with the vectorized kernel first,
+    // then scatter the integers into the frames.
+    IntegerFormat format = integerFormat(sampleFormat);
+    int32_t block[BlockSize];
+    AudioSample dither[BlockSize];
+    if(_dither) {
+        generateDither(dither, frames);
+    }
+    AudioKernels::toInteger(channel, block, frames, format.scale,
+                            format.minimum, format.maximum, _dither ? dither : 0);
+
+    switch(sampleFormat) {
+    case SampleFormatInt16:
+        for(int i = 0; i < frames; i++) {
+            qint16 value = (qint16)block[i];
+            memcpy(destination + i * stride, &value, sizeof(value));
+        }
+        break;
+    case SampleFormatInt24:
+        for(int i = 0; i < frames; i++) {
+            char *sample = destination + i * stride;
+            sample[0] = (char)(block[i] & 0xff);
+            sample[1] = (char)((block[i] >> 8) & 0xff);
+            sample[2] = (char)((block[i] >> 16) & 0xff);
+        }
+        break;
+    default:
+        for(int i = 0; i < frames; i++) {
+            memcpy(destination + i * stride, block + i, sizeof(int32_t));
+        }
+        break;
+    }
+}
+
+void SampleConverter::loadChannel(const char *source, int stride, int frames,
+                                  AudioSample *channel, SampleFormat sampleFormat) {
+    if(sampleFormat == SampleFormatFloat32) {
+        for(int i = 0; i < frames; i++) {
+            memcpy(channel + i, source + i * stride, sizeof(AudioSample));
+        }
+        return;
+    }
+
+    // Gather the integers of this channel first, then convert the
+    // contiguous block with the vectorized kernel.
+    IntegerFormat format = integerFormat(sampleFormat);
+    int32_t block[BlockSize];
+    switch(sampleFormat) {
+    case SampleFormatInt16:
+        for(int i = 0; i < frames; i++) {
+            qint16 value;
+            memcpy(&value, source + i * stride, sizeof(value));
+            block[i] = value;
+        }
+        break;
+    case SampleFormatInt24:
+        for(int i = 0; i < frames; i++) {
+            const unsigned char *sample = (const unsigned char*)(source + i * stride);
+            quint32 value = (quint32)sample[0] << 8 | (quint32)sample[1] << 16 | (quint32)sample[2] << 24;
+            block[i] = (int32_t)value >> 8;
+        }
+        break;
+    default:
+        for(int i = 0; i < frames; i++) {
+            memcpy(block + i, source + i * stride, sizeof(int32_t));
+        }
+        break;
+    }
+
+    AudioKernels::fromInteger(block, channel, frames, 1.0f / format.scale);
+}
+
+void SampleConverter::generateDither(AudioSample *dither, int count) {
+    // Triangular noise of +/- 1 LSB is the difference of two uniform
+    // random values, generated with a xorshift generator.
+    const AudioSample unit = 1.0f / 16777216.0f;
+    quint32 state = _ditherState;
+    for(int i = 0; i < count; i++) {
+        state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+        AudioSample a = (AudioSample)(state >> 8) * unit;
+        state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+        AudioSample b = (AudioSample)(state >> 8) * unit;
+        dither[i] = a - b;
+    }
+    _ditherState = state;
+}
+
+} // namespace QtJack